@@ -791,6 +791,36 @@ kern_sock_getname_2args, [
 EXTRA_KCFLAGS="$tmp_flags"
 ]) # LN_CONFIG_SOCK_GETNAME
 
+#
+# LN_CONFIG_SOCK_RECVMSG_BVEC
+#
+# 4.20 "iov_iter: Separate type from direction and use accessor
+# functions" dropped the ITER_BVEC flag from the iov_iter_bvec()
+# direction argument. socklnd
+# receives pages through a bvec msg_iter only with that calling form and
+# the 3 argument sock_recvmsg() (4.7).
+#
+AC_DEFUN([LN_CONFIG_SOCK_RECVMSG_BVEC], [
+tmp_flags="$EXTRA_KCFLAGS"
+EXTRA_KCFLAGS="-Werror"
+LB_CHECK_COMPILE([if sock_recvmsg() can receive into a bvec iterator],
+sock_recvmsg_bvec, [
+	#include <linux/net.h>
+	#include <linux/socket.h>
+	#include <linux/uio.h>
+],[
+	struct msghdr msg = { 0 };
+
+	iov_iter_bvec(&msg.msg_iter, READ, NULL, 0, 0);
+	(void)iov_iter_type(&msg.msg_iter);
+	sock_recvmsg(NULL, &msg, MSG_DONTWAIT);
+],[
+	AC_DEFINE(HAVE_SOCK_RECVMSG_BVEC, 1,
+		[sock_recvmsg() can receive into a bvec iterator])
+])
+EXTRA_KCFLAGS="$tmp_flags"
+]) # LN_CONFIG_SOCK_RECVMSG_BVEC
+
 #
 # LN_HAVE_IN_DEV_FOR_EACH_IFA_RTNL
 #
@@ -894,6 +924,8 @@ LN_CONFIG_SOCK_CREATE_KERN
 LN_CONFIG_SOCK_ACCEPT
 # 4.17
 LN_CONFIG_SOCK_GETNAME
+# 4.20
+LN_CONFIG_SOCK_RECVMSG_BVEC
 # 5.3 and 4.18.0-193.el8
 LN_HAVE_IN_DEV_FOR_EACH_IFA_RTNL
 ]) # LN_PROG_LINUX
@@ -199,6 +199,7 @@ lnet_net_lock_current(void)
 extern struct kmem_cache *lnet_mes_cachep;	 /* MEs kmem_cache */
 extern struct kmem_cache *lnet_small_mds_cachep; /* <= LNET_SMALL_MD_SIZE bytes
 						  * MDs kmem_cache */
+extern struct kmem_cache *lnet_msgs_cachep;	 /* messages kmem_cache */
 
 static inline struct lnet_eq *
 lnet_eq_alloc (void)
@@ -487,17 +488,22 @@ lnet_msg_alloc(void)
 {
 	struct lnet_msg *msg;
 
-	LIBCFS_ALLOC(msg, sizeof(*msg));
+	msg = kmem_cache_alloc(lnet_msgs_cachep, GFP_NOFS | __GFP_ZERO);
 
-	/* no need to zero, LIBCFS_ALLOC does for us */
-	return (msg);
+	if (msg)
+		CDEBUG(D_MALLOC, "slab-alloced 'msg' at %p.\n", msg);
+	else
+		CDEBUG(D_MALLOC, "failed to allocate 'msg'\n");
+
+	return msg;
 }
 
 static inline void
 lnet_msg_free(struct lnet_msg *msg)
 {
 	LASSERT(!msg->msg_onactivelist);
-	LIBCFS_FREE(msg, sizeof(*msg));
+	CDEBUG(D_MALLOC, "slab-freed 'msg' at %p.\n", msg);
+	kmem_cache_free(lnet_msgs_cachep, msg);
 }
 
 static inline struct lnet_rsp_tracker *
@@ -669,6 +675,7 @@ lnet_ptl_unsetopt(struct lnet_portal *ptl, int opt)
 }
 
 /* match-table functions */
+void lnet_mt_grow(struct lnet_match_table *mtable);
 struct list_head *lnet_mt_match_head(struct lnet_match_table *mtable,
 			       struct lnet_process_id id, __u64 mbits);
 struct lnet_match_table *lnet_mt_of_attach(unsigned int index,
@@ -908,6 +908,10 @@ struct lnet_match_info {
 #define LNET_MT_BITS_U64		6	/* 2^6 bits */
 #define LNET_MT_EXHAUSTED_BITS		(LNET_MT_HASH_BITS - LNET_MT_BITS_U64)
 #define LNET_MT_EXHAUSTED_BMAP		((1 << LNET_MT_EXHAUSTED_BITS) + 1)
+/* the hash of a unique portal grows up to 2^LNET_MT_HASH_BITS_MAX chains
+ * to keep an average of at most LNET_MT_HASH_LOAD MEs per chain */
+#define LNET_MT_HASH_BITS_MAX		14
+#define LNET_MT_HASH_LOAD		2
 
 /* portal match table */
 struct lnet_match_table {
@@ -920,6 +924,10 @@ struct lnet_match_table {
 	/* bitmap to flag whether MEs on mt_hash are exhausted or not */
 	__u64			mt_exhausted[LNET_MT_EXHAUSTED_BMAP];
 	struct list_head	*mt_mhash;	/* matching hash */
+	/* log2 of # chains in mt_mhash, only grows on unique portal */
+	unsigned int		mt_hash_bits;
+	/* # MEs attached, protected by lnet_res_lock(mt_cpt) */
+	unsigned int		mt_nmes;
 };
 
 /* these are only useful for wildcard portal */
@@ -81,6 +81,8 @@ ksocknal_create_route(__u32 ipaddr, int port)
         route->ksnr_deleted = 0;
         route->ksnr_conn_count = 0;
         route->ksnr_share_count = 0;
+	memset(route->ksnr_ctype_conns, 0, sizeof(route->ksnr_ctype_conns));
+	route->ksnr_ctype_refused = 0;
 
         return (route);
 }
@@ -355,6 +357,7 @@ ksocknal_associate_route_conn_locked(struct ksock_route *route, struct ksock_con
         }
 
         route->ksnr_connected |= (1<<type);
+	route->ksnr_ctype_conns[type]++;
         route->ksnr_conn_count++;
 
         /* Successful connection => further attempts can
@@ -1206,9 +1209,17 @@ ksocknal_create_conn(struct lnet_ni *ni, struct ksock_route *route,
                 goto failed_2;
         }
 
-	/* Refuse to duplicate an existing connection, unless this is a
-	 * loopback connection */
+	/* Refuse to duplicate an existing connection beyond conns_per_peer,
+	 * unless this is a loopback connection. The connecting side decides
+	 * how many bulk connections it wants, so accept up to the maximum
+	 * on a passive connection in case the peer's tunable differs. */
 	if (conn->ksnc_ipaddr != conn->ksnc_myipaddr) {
+		int nconns = 0;
+		int maxconns = ksocknal_conns_per_type(conn->ksnc_type);
+
+		if (!active && conn->ksnc_type != SOCKLND_CONN_CONTROL)
+			maxconns = SOCKNAL_CONNS_PER_PEER_MAX;
+
 		list_for_each(tmp, &peer_ni->ksnp_conns) {
 			conn2 = list_entry(tmp, struct ksock_conn, ksnc_list);
 
@@ -1217,6 +1228,9 @@ ksocknal_create_conn(struct lnet_ni *ni, struct ksock_route *route,
                             conn2->ksnc_type != conn->ksnc_type)
                                 continue;
 
+			if (++nconns < maxconns)
+				continue;
+
                         /* Reply on a passive connection attempt so the peer_ni
                          * realises we're connected. */
                         LASSERT (rc == 0);
@@ -1438,6 +1452,8 @@ ksocknal_close_conn_locked(struct ksock_conn *conn, int error)
 		/* dissociate conn from route... */
 		LASSERT(!route->ksnr_deleted);
 		LASSERT((route->ksnr_connected & (1 << conn->ksnc_type)) != 0);
+		LASSERT(route->ksnr_ctype_conns[conn->ksnc_type] > 0);
+		route->ksnr_ctype_conns[conn->ksnc_type]--;
 
 		conn2 = NULL;
 		list_for_each(tmp, &peer_ni->ksnp_conns) {
@@ -1449,8 +1465,12 @@ ksocknal_close_conn_locked(struct ksock_conn *conn, int error)
 
 			conn2 = NULL;
 		}
-		if (conn2 == NULL)
+		if (conn2 == NULL) {
 			route->ksnr_connected &= ~(1 << conn->ksnc_type);
+			/* the peer may accept extra connections again after
+			 * it restarts, ask for them on the next connect */
+			route->ksnr_ctype_refused &= ~(1 << conn->ksnc_type);
+		}
 
 		conn->ksnc_route = NULL;
 
@@ -1641,7 +1661,8 @@ ksocknal_destroy_conn(struct ksock_conn *conn)
 	time64_t last_rcv;
 
 	/* Final coup-de-grace of the reaper */
-	CDEBUG (D_NET, "connection %p\n", conn);
+	CDEBUG(D_NET, "connection %p, rx page bytes %llu direct %llu mapped\n",
+	       conn, conn->ksnc_rx_direct_nob, conn->ksnc_rx_mapped_nob);
 
 	LASSERT (atomic_read (&conn->ksnc_conn_refcount) == 0);
 	LASSERT (atomic_read (&conn->ksnc_sock_refcount) == 0);
@@ -2197,6 +2218,7 @@ ksocknal_ctl(struct lnet_ni *ni, unsigned int cmd, void *arg)
 		data->ioc_u32[4] = conn->ksnc_scheduler->kss_cpt;
                 data->ioc_u32[5] = rxmem;
                 data->ioc_u32[6] = conn->ksnc_peer->ksnp_id.pid;
+		data->ioc_u64[0] = conn->ksnc_rx_direct_nob;
                 ksocknal_conn_decref(conn);
                 return 0;
         }
@@ -2253,7 +2275,7 @@ ksocknal_free_buffers (void)
 		while (!list_empty(&zlist)) {
 			tx = list_entry(zlist.next, struct ksock_tx, tx_list);
 			list_del(&tx->tx_list);
-			LIBCFS_FREE(tx, tx->tx_desc_size);
+			ksocknal_free_tx_desc(tx);
 		}
 	} else {
 		spin_unlock(&ksocknal_data.ksnd_tx_lock);
@@ -2820,9 +2842,12 @@ ksocknal_startup(struct lnet_ni *ni)
 }
 
 
+struct kmem_cache *ksocknal_small_tx_cachep;
+
 static void __exit ksocklnd_exit(void)
 {
 	lnet_unregister_lnd(&the_ksocklnd);
+	kmem_cache_destroy(ksocknal_small_tx_cachep);
 }
 
 static int __init ksocklnd_init(void)
@@ -2848,6 +2873,14 @@ static int __init ksocklnd_init(void)
 	if (rc != 0)
 		return rc;
 
+	/* small messages and their tx descriptors come and go at the
+	 * message rate, keep them on a slab of their own */
+	ksocknal_small_tx_cachep = kmem_cache_create("ksock_small_tx",
+						     KSOCK_SMALL_TX_SIZE, 0,
+						     0, NULL);
+	if (ksocknal_small_tx_cachep == NULL)
+		return -ENOMEM;
+
 	lnet_register_lnd(&the_ksocklnd);
 
 	return 0;
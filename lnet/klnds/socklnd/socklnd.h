@@ -74,6 +74,7 @@
 #define SOCKNAL_RESCHED         100             /* # scheduler loops before reschedule */
 #define SOCKNAL_INSANITY_RECONN 5000            /* connd is trying on reconn infinitely */
 #define SOCKNAL_ENOMEM_RETRY    1		/* seconds between retries */
+#define SOCKNAL_CONNS_PER_PEER_MAX 16		/* max bulk conns per type */
 
 #define SOCKNAL_SINGLE_FRAG_TX      0           /* disable multi-fragment sends */
 #define SOCKNAL_SINGLE_FRAG_RX      0           /* disable multi-fragment receives */
@@ -134,6 +135,7 @@ struct ksock_tunables {
         int              *ksnd_eager_ack;       /* make TCP ack eagerly? */
         int              *ksnd_typed_conns;     /* drive sockets by type? */
         int              *ksnd_min_bulk;        /* smallest "large" message */
+	int		 *ksnd_conns_per_peer;	/* # bulk conns per type */
         int              *ksnd_tx_buffer_size;  /* socket tx buffer size */
         int              *ksnd_rx_buffer_size;  /* socket rx buffer size */
         int              *ksnd_nagle;           /* enable NAGLE? */
@@ -152,6 +154,7 @@ struct ksock_tunables {
         unsigned int     *ksnd_zc_min_payload;  /* minimum zero copy payload size */
         int              *ksnd_zc_recv;         /* enable ZC receive (for Chelsio TOE) */
         int              *ksnd_zc_recv_min_nfrags; /* minimum # of fragments to enable ZC receive */
+	int		 *ksnd_direct_recv;	/* receive pages without kmap */
 #ifdef CPU_AFFINITY
         int              *ksnd_irq_affinity;    /* enable IRQ affinity? */
 #endif
@@ -288,6 +291,11 @@ struct ksock_tx {			/* transmit packet */
 };
 
 #define KSOCK_NOOP_TX_SIZE  ((int)offsetof(struct ksock_tx, tx_frags.paged.kiov[0]))
+/* tx descriptors of messages with at most one payload fragment come from
+ * ksocknal_small_tx_cachep */
+#define KSOCK_SMALL_TX_SIZE \
+	((int)max(offsetof(struct ksock_tx, tx_frags.virt.iov[2]), \
+		  offsetof(struct ksock_tx, tx_frags.paged.kiov[1])))
 
 /* network zero copy callback descriptor embedded in struct ksock_tx */
 
@@ -342,6 +350,8 @@ struct ksock_conn {
         lnet_kiov_t          *ksnc_rx_kiov;     /* the page frags */
 	union ksock_rxiovspace	ksnc_rx_iov_space;/* space for frag descriptors */
         __u32                 ksnc_rx_csum;     /* partial checksum for incoming data */
+	__u64			ksnc_rx_direct_nob; /* page bytes received unmapped */
+	__u64			ksnc_rx_mapped_nob; /* page bytes received via kmap/vmap */
 	struct lnet_msg      *ksnc_lnet_msg;    /* rx lnet_finalize arg*/
 	struct ksock_msg	ksnc_msg;	/* incoming message buffer:
 						 * V2.x message takes the
@@ -384,6 +394,10 @@ struct ksock_route {
         unsigned int          ksnr_scheduled:1; /* scheduled for attention */
         unsigned int          ksnr_connecting:1;/* connection establishment in progress */
         unsigned int          ksnr_connected:4; /* connections established by type */
+	/* # connections established per type */
+	unsigned short	      ksnr_ctype_conns[SOCKLND_CONN_NTYPES];
+	/* types the peer refused an extra connection of */
+	unsigned int	      ksnr_ctype_refused:4;
         unsigned int          ksnr_deleted:1;   /* been removed from peer_ni? */
         unsigned int          ksnr_share_count; /* created explicitly? */
         int                   ksnr_conn_count;  /* # conns established by this route */
@@ -483,6 +497,41 @@ ksocknal_route_mask(void)
                 (1 << SOCKLND_CONN_BULK_OUT));
 }
 
+/* # connections of \a type wanted on one route */
+static inline int
+ksocknal_conns_per_type(int type)
+{
+	/* a single control connection keeps small messages in order */
+	if (type == SOCKLND_CONN_CONTROL)
+		return 1;
+
+	return min(*ksocknal_tunables.ksnd_conns_per_peer,
+		   SOCKNAL_CONNS_PER_PEER_MAX);
+}
+
+/* connection types \a route still has to establish; a peer that refused
+ * an extra connection of a type only gets the first one of that type */
+static inline int
+ksocknal_route_wanted(struct ksock_route *route)
+{
+	int mask = ksocknal_route_mask();
+	int wanted = 0;
+	int type;
+
+	for (type = 0; type < SOCKLND_CONN_NTYPES; type++) {
+		int max = ksocknal_conns_per_type(type);
+
+		if ((route->ksnr_ctype_refused & (1 << type)) != 0)
+			max = 1;
+
+		if ((mask & (1 << type)) != 0 &&
+		    route->ksnr_ctype_conns[type] < max)
+			wanted |= 1 << type;
+	}
+
+	return wanted;
+}
+
 static inline struct list_head *
 ksocknal_nid2peerlist (lnet_nid_t nid)
 {
@@ -620,8 +669,10 @@ extern struct ksock_conn *ksocknal_find_conn_locked(struct ksock_peer_ni *peer_n
 
 extern int  ksocknal_launch_packet(struct lnet_ni *ni, struct ksock_tx *tx,
 				   struct lnet_process_id id);
+extern struct kmem_cache *ksocknal_small_tx_cachep;
 extern struct ksock_tx *ksocknal_alloc_tx(int type, int size);
 extern void ksocknal_free_tx(struct ksock_tx *tx);
+extern void ksocknal_free_tx_desc(struct ksock_tx *tx);
 extern struct ksock_tx *ksocknal_alloc_tx_noop(__u64 cookie, int nonblk);
 extern void ksocknal_next_tx_carrier(struct ksock_conn *conn);
 extern void ksocknal_queue_tx_locked(struct ksock_tx *tx, struct ksock_conn *conn);
@@ -47,8 +47,13 @@ ksocknal_alloc_tx(int type, int size)
 		spin_unlock(&ksocknal_data.ksnd_tx_lock);
         }
 
-        if (tx == NULL)
-                LIBCFS_ALLOC(tx, size);
+	if (tx == NULL) {
+		if (size <= KSOCK_SMALL_TX_SIZE)
+			tx = kmem_cache_alloc(ksocknal_small_tx_cachep,
+					      GFP_NOFS | __GFP_ZERO);
+		else
+			LIBCFS_ALLOC(tx, size);
+	}
 
         if (tx == NULL)
                 return NULL;
@@ -106,10 +111,19 @@ ksocknal_free_tx(struct ksock_tx *tx)
 
 		spin_unlock(&ksocknal_data.ksnd_tx_lock);
 	} else {
-		LIBCFS_FREE(tx, tx->tx_desc_size);
+		ksocknal_free_tx_desc(tx);
 	}
 }
 
+void
+ksocknal_free_tx_desc(struct ksock_tx *tx)
+{
+	if (tx->tx_desc_size <= KSOCK_SMALL_TX_SIZE)
+		kmem_cache_free(ksocknal_small_tx_cachep, tx);
+	else
+		LIBCFS_FREE(tx, tx->tx_desc_size);
+}
+
 static int
 ksocknal_send_iov(struct ksock_conn *conn, struct ksock_tx *tx,
 		  struct kvec *scratch_iov)
@@ -647,7 +661,7 @@ ksocknal_launch_connection_locked(struct ksock_route *route)
 
         LASSERT (!route->ksnr_scheduled);
         LASSERT (!route->ksnr_connecting);
-        LASSERT ((ksocknal_route_mask() & ~route->ksnr_connected) != 0);
+	LASSERT(ksocknal_route_wanted(route) != 0);
 
         route->ksnr_scheduled = 1;              /* scheduling conn for connd */
         ksocknal_route_addref(route);           /* extra ref for connd */
@@ -848,9 +862,9 @@ ksocknal_find_connectable_route_locked(struct ksock_peer_ni *peer_ni)
                 if (route->ksnr_scheduled)      /* connections being established */
                         continue;
 
-                /* all route types connected ? */
-                if ((ksocknal_route_mask() & ~route->ksnr_connected) == 0)
-                        continue;
+		/* all route types connected ? */
+		if (ksocknal_route_wanted(route) == 0)
+			continue;
 
                 if (!(route->ksnr_retry_interval == 0 || /* first attempt */
 		      now >= route->ksnr_timeout)) {
@@ -1952,7 +1966,7 @@ ksocknal_connect(struct ksock_route *route)
         route->ksnr_connecting = 1;
 
         for (;;) {
-                wanted = ksocknal_route_mask() & ~route->ksnr_connected;
+		wanted = ksocknal_route_wanted(route);
 
                 /* stop connecting if peer_ni/route got closed under me, or
                  * route got connected while queued */
@@ -1973,6 +1987,11 @@ ksocknal_connect(struct ksock_route *route)
                 if (retry_later) /* needs reschedule */
                         break;
 
+		/* open the first connection of every type before the extra
+		 * bulk ones, so a peer refusing extras can't starve a type */
+		if ((wanted & ~route->ksnr_connected) != 0)
+			wanted &= ~route->ksnr_connected;
+
                 if ((wanted & (1 << SOCKLND_CONN_ANY)) != 0) {
                         type = SOCKLND_CONN_ANY;
                 } else if ((wanted & (1 << SOCKLND_CONN_CONTROL)) != 0) {
@@ -2012,11 +2031,22 @@ ksocknal_connect(struct ksock_route *route)
                 /* A +ve RC means I have to retry because I lost the connection
                  * race or I have to renegotiate protocol version */
                 retry_later = (rc != 0);
+
+		write_lock_bh(&ksocknal_data.ksnd_global_lock);
+
+		/* The peer refused an extra connection of a type I already
+		 * have, e.g. it only accepts one per type: stop asking. */
+		if (rc == EALREADY && route->ksnr_ctype_conns[type] > 0) {
+			CDEBUG(D_NET, "peer_ni %s: refused extra conn type %d\n",
+			       libcfs_nid2str(peer_ni->ksnp_id.nid), type);
+			route->ksnr_ctype_refused |= 1 << type;
+			retry_later = 0;
+			continue;
+		}
+
                 if (retry_later)
                         CDEBUG(D_NET, "peer_ni %s: conn race, retry later.\n",
                                libcfs_nid2str(peer_ni->ksnp_id.nid));
-
-		write_lock_bh(&ksocknal_data.ksnd_global_lock);
         }
 
         route->ksnr_scheduled = 0;
@@ -299,6 +299,70 @@ ksocknal_lib_kiov_vmap(lnet_kiov_t *kiov, int niov,
         return addr;
 }
 
+#ifdef HAVE_SOCK_RECVMSG_BVEC
+/* max # of page frags handed to the socket in one direct receive */
+#define KSOCK_RX_BVEC_BATCH	16
+
+/*
+ * Receive into the pages through a bvec iterator. The socket copies the
+ * payload out of its skbs straight into the destination pages, so there is
+ * no need to kmap() every fragment or vmap() the whole kiov first, which
+ * is where most of the receive overhead went besides the copy itself.
+ * Works for any fragment layout, so unaligned payloads need no fallback.
+ */
+static int
+ksocknal_lib_recv_kiov_direct(struct ksock_conn *conn)
+{
+	struct bio_vec bv[KSOCK_RX_BVEC_BATCH];
+	lnet_kiov_t *kiov = conn->ksnc_rx_kiov;
+	unsigned int niov = min_t(unsigned int, conn->ksnc_rx_nkiov,
+				  KSOCK_RX_BVEC_BATCH);
+	struct msghdr msg = {
+		.msg_flags	= 0
+	};
+	void *base;
+	int fragnob;
+	int sum;
+	int nob;
+	int rc;
+	int i;
+
+	for (nob = i = 0; i < niov; i++) {
+		bv[i].bv_page = kiov[i].kiov_page;
+		bv[i].bv_len = kiov[i].kiov_len;
+		bv[i].bv_offset = kiov[i].kiov_offset;
+		nob += kiov[i].kiov_len;
+	}
+
+	LASSERT(nob <= conn->ksnc_rx_nob_wanted);
+
+	iov_iter_bvec(&msg.msg_iter, READ, bv, niov, nob);
+	rc = sock_recvmsg(conn->ksnc_sock, &msg, MSG_DONTWAIT);
+	if (rc <= 0)
+		return rc;
+
+	conn->ksnc_rx_direct_nob += rc;
+
+	if (conn->ksnc_msg.ksm_csum != 0) {
+		for (i = 0, sum = rc; sum > 0; i++, sum -= fragnob) {
+			LASSERT(i < niov);
+
+			base = kmap(kiov[i].kiov_page) + kiov[i].kiov_offset;
+			fragnob = kiov[i].kiov_len;
+			if (fragnob > sum)
+				fragnob = sum;
+
+			conn->ksnc_rx_csum = ksocknal_csum(conn->ksnc_rx_csum,
+							   base, fragnob);
+
+			kunmap(kiov[i].kiov_page);
+		}
+	}
+
+	return rc;
+}
+#endif /* HAVE_SOCK_RECVMSG_BVEC */
+
 int
 ksocknal_lib_recv_kiov(struct ksock_conn *conn, struct page **pages,
 		       struct kvec *scratchiov)
@@ -327,6 +391,13 @@ ksocknal_lib_recv_kiov(struct ksock_conn *conn, struct page **pages,
         int          fragnob;
 	int n;
 
+#ifdef HAVE_SOCK_RECVMSG_BVEC
+	/* the Chelsio TOE zc_recv path still wants a vmapped buffer */
+	if (*ksocknal_tunables.ksnd_direct_recv &&
+	    !*ksocknal_tunables.ksnd_zc_recv)
+		return ksocknal_lib_recv_kiov_direct(conn);
+#endif
+
         /* NB we can't trust socket ops to either consume our iovs
          * or leave them alone. */
 	if ((addr = ksocknal_lib_kiov_vmap(kiov, niov, scratchiov, pages)) != NULL) {
@@ -346,6 +417,8 @@ ksocknal_lib_recv_kiov(struct ksock_conn *conn, struct page **pages,
 
 	rc = kernel_recvmsg(conn->ksnc_sock, &msg, scratchiov, n, nob,
 			    MSG_DONTWAIT);
+	if (rc > 0)
+		conn->ksnc_rx_mapped_nob += rc;
 
         if (conn->ksnc_msg.ksm_csum != 0) {
                 for (i = 0, sum = rc; sum > 0; i++, sum -= fragnob) {
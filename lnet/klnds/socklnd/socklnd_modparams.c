@@ -75,6 +75,44 @@ static int min_bulk = (1<<10);
 module_param(min_bulk, int, 0644);
 MODULE_PARM_DESC(min_bulk, "smallest 'large' message");
 
+static int conns_per_peer = 1;
+static int conns_per_peer_set(const char *val, cfs_kernel_param_arg_t *kp);
+#ifdef HAVE_KERNEL_PARAM_OPS
+static struct kernel_param_ops param_ops_conns_per_peer = {
+	.set = conns_per_peer_set,
+	.get = param_get_int,
+};
+#define param_check_conns_per_peer(name, p) \
+		__param_check(name, p, int)
+module_param(conns_per_peer, conns_per_peer, 0644);
+#else
+module_param_call(conns_per_peer, conns_per_peer_set, param_get_int,
+		  &conns_per_peer, 0644);
+#endif
+MODULE_PARM_DESC(conns_per_peer, "number of bulk connections to open per peer and type");
+
+static int
+conns_per_peer_set(const char *val, cfs_kernel_param_arg_t *kp)
+{
+	int value, rc;
+
+	rc = kstrtoint(val, 0, &value);
+	if (rc) {
+		CERROR("Invalid module parameter value for 'conns_per_peer'\n");
+		return rc;
+	}
+
+	if (value < 1 || value > SOCKNAL_CONNS_PER_PEER_MAX) {
+		CERROR("conns_per_peer %d out of range [1, %d]\n",
+		       value, SOCKNAL_CONNS_PER_PEER_MAX);
+		return -ERANGE;
+	}
+
+	*(int *)kp->arg = value;
+
+	return 0;
+}
+
 # define DEFAULT_BUFFER_SIZE 0
 static int tx_buffer_size = DEFAULT_BUFFER_SIZE;
 module_param(tx_buffer_size, int, 0644);
@@ -139,6 +177,10 @@ static unsigned int zc_recv_min_nfrags = 16;
 module_param(zc_recv_min_nfrags, int, 0644);
 MODULE_PARM_DESC(zc_recv_min_nfrags, "minimum # of fragments to enable ZC recv");
 
+static int direct_recv = 1;
+module_param(direct_recv, int, 0644);
+MODULE_PARM_DESC(direct_recv, "receive bulk data straight into pages without mapping them");
+
 #ifdef SOCKNAL_BACKOFF
 static int backoff_init = 3;
 module_param(backoff_init, int, 0644);
@@ -170,6 +212,7 @@ int ksocknal_tunables_init(void)
         ksocknal_tunables.ksnd_eager_ack          = &eager_ack;
         ksocknal_tunables.ksnd_typed_conns        = &typed_conns;
         ksocknal_tunables.ksnd_min_bulk           = &min_bulk;
+	ksocknal_tunables.ksnd_conns_per_peer	  = &conns_per_peer;
         ksocknal_tunables.ksnd_tx_buffer_size     = &tx_buffer_size;
         ksocknal_tunables.ksnd_rx_buffer_size     = &rx_buffer_size;
         ksocknal_tunables.ksnd_nagle              = &nagle;
@@ -188,6 +231,7 @@ int ksocknal_tunables_init(void)
         ksocknal_tunables.ksnd_zc_min_payload     = &zc_min_payload;
         ksocknal_tunables.ksnd_zc_recv            = &zc_recv;
         ksocknal_tunables.ksnd_zc_recv_min_nfrags = &zc_recv_min_nfrags;
+	ksocknal_tunables.ksnd_direct_recv = &direct_recv;
 
 #ifdef CPU_AFFINITY
 	if (enable_irq_affinity) {
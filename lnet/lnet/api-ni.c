@@ -557,6 +557,7 @@ lnet_fini_locks(void)
 struct kmem_cache *lnet_mes_cachep;	   /* MEs kmem_cache */
 struct kmem_cache *lnet_small_mds_cachep;  /* <= LNET_SMALL_MD_SIZE bytes
 					    *  MDs kmem_cache */
+struct kmem_cache *lnet_msgs_cachep;	   /* messages kmem_cache */
 
 static int
 lnet_descriptor_setup(void)
@@ -575,6 +576,14 @@ lnet_descriptor_setup(void)
 	if (!lnet_small_mds_cachep)
 		return -ENOMEM;
 
+	/* every send and receive allocates a message, the slab's per-CPU
+	 * freelists keep that off the page allocator and general caches */
+	lnet_msgs_cachep = kmem_cache_create("lnet_msgs",
+					     sizeof(struct lnet_msg), 0, 0,
+					     NULL);
+	if (!lnet_msgs_cachep)
+		return -ENOMEM;
+
 	return 0;
 }
 
@@ -582,6 +591,11 @@ static void
 lnet_descriptor_cleanup(void)
 {
 
+	if (lnet_msgs_cachep) {
+		kmem_cache_destroy(lnet_msgs_cachep);
+		lnet_msgs_cachep = NULL;
+	}
+
 	if (lnet_small_mds_cachep) {
 		kmem_cache_destroy(lnet_small_mds_cachep);
 		lnet_small_mds_cachep = NULL;
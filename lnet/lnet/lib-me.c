@@ -114,10 +114,13 @@ LNetMEAttach(unsigned int portal,
 		list_add_tail(&me->me_list, head);
 	else
 		list_add(&me->me_list, head);
+	mtable->mt_nmes++;
 
 	lnet_me2handle(handle, me);
 
 	lnet_res_unlock(mtable->mt_cpt);
+
+	lnet_mt_grow(mtable);
 	return 0;
 }
 EXPORT_SYMBOL(LNetMEAttach);
@@ -196,6 +199,7 @@ LNetMEInsert(struct lnet_handle_me current_meh,
 		list_add(&new_me->me_list, &current_me->me_list);
 	else
 		list_add_tail(&new_me->me_list, &current_me->me_list);
+	ptl->ptl_mtables[cpt]->mt_nmes++;
 
 	lnet_me2handle(handle, new_me);
 
@@ -258,7 +262,10 @@ EXPORT_SYMBOL(LNetMEUnlink);
 void
 lnet_me_unlink(struct lnet_me *me)
 {
+	struct lnet_portal *ptl = the_lnet.ln_portals[me->me_portal];
+
 	list_del(&me->me_list);
+	ptl->ptl_mtables[lnet_cpt_of_cookie(me->me_lh.lh_cookie)]->mt_nmes--;
 
 	if (me->me_md != NULL) {
 		struct lnet_libmd *md = me->me_md;
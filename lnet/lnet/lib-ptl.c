@@ -366,11 +366,78 @@ lnet_mt_match_head(struct lnet_match_table *mtable,
 		unsigned long hash = mbits + id.nid + id.pid;
 
 		LASSERT(lnet_ptl_is_unique(ptl));
-		hash = hash_long(hash, LNET_MT_HASH_BITS);
-		return &mtable->mt_mhash[hash & LNET_MT_HASH_MASK];
+		hash = hash_long(hash, mtable->mt_hash_bits);
+		return &mtable->mt_mhash[hash &
+					 ((1UL << mtable->mt_hash_bits) - 1)];
 	}
 }
 
+/*
+ * MEs of a unique portal (ptlrpc replies and bulk buffers) are matched by
+ * exact match bits, so matching an incoming message costs the length of
+ * one hash chain. A busy server posts thousands of them, so double the
+ * hash once chains average more than LNET_MT_HASH_LOAD MEs. Called without
+ * lock after attaching an ME.
+ */
+void
+lnet_mt_grow(struct lnet_match_table *mtable)
+{
+	struct lnet_portal *ptl = the_lnet.ln_portals[mtable->mt_portal];
+	struct list_head *mhash;
+	struct list_head *old;
+	struct list_head *head;
+	struct lnet_me *me;
+	struct lnet_me *tmp;
+	unsigned int bits;
+	int i;
+
+	if (!lnet_ptl_is_unique(ptl))
+		return;
+
+	bits = mtable->mt_hash_bits;
+	if (bits >= LNET_MT_HASH_BITS_MAX ||
+	    mtable->mt_nmes <= (LNET_MT_HASH_LOAD << bits))
+		return;
+
+	/* the extra entry is for MEs with ignore bits */
+	LIBCFS_CPT_ALLOC(mhash, lnet_cpt_table(), mtable->mt_cpt,
+			 sizeof(*mhash) * ((1 << (bits + 1)) + 1));
+	if (mhash == NULL)
+		return; /* keep using the current hash */
+
+	for (i = 0; i < (1 << (bits + 1)) + 1; i++)
+		INIT_LIST_HEAD(&mhash[i]);
+
+	lnet_res_lock(mtable->mt_cpt);
+	if (mtable->mt_hash_bits != bits) {
+		/* grown by someone else */
+		lnet_res_unlock(mtable->mt_cpt);
+		LIBCFS_FREE(mhash, sizeof(*mhash) * ((1 << (bits + 1)) + 1));
+		return;
+	}
+
+	old = mtable->mt_mhash;
+	mtable->mt_mhash = mhash;
+	mtable->mt_hash_bits = bits + 1;
+	/* MEs with the same match criteria always share a chain, so moving
+	 * them in order keeps their relative order */
+	for (i = 0; i < (1 << bits) + 1; i++) {
+		list_for_each_entry_safe(me, tmp, &old[i], me_list) {
+			head = lnet_mt_match_head(mtable, me->me_match_id,
+						  me->me_match_bits);
+			me->me_pos = head - mhash;
+			list_move_tail(&me->me_list, head);
+		}
+	}
+	lnet_res_unlock(mtable->mt_cpt);
+
+	CDEBUG(D_NET, "portal %d cpt %d: %u MEs, hash grown to %u chains\n",
+	       mtable->mt_portal, mtable->mt_cpt, mtable->mt_nmes,
+	       1 << (bits + 1));
+
+	LIBCFS_FREE(old, sizeof(*old) * ((1 << bits) + 1));
+}
+
 int
 lnet_mt_match_md(struct lnet_match_table *mtable,
 		 struct lnet_match_info *info, struct lnet_msg *msg)
@@ -381,8 +448,10 @@ lnet_mt_match_md(struct lnet_match_table *mtable,
 	int			exhausted = 0;
 	int			rc;
 
-	/* any ME with ignore bits? */
-	if (!list_empty(&mtable->mt_mhash[LNET_MT_HASH_IGNORE]))
+	/* any ME with ignore bits? (never on unique portal, whose hash may
+	 * have grown beyond LNET_MT_HASH_SIZE) */
+	if (lnet_ptl_is_wildcard(the_lnet.ln_portals[mtable->mt_portal]) &&
+	    !list_empty(&mtable->mt_mhash[LNET_MT_HASH_IGNORE]))
 		head = &mtable->mt_mhash[LNET_MT_HASH_IGNORE];
 	else
 		head = lnet_mt_match_head(mtable, info->mi_id, info->mi_mbits);
@@ -762,7 +831,7 @@ lnet_ptl_cleanup(struct lnet_portal *ptl)
 
 		mhash = mtable->mt_mhash;
 		/* cleanup ME */
-		for (j = 0; j < LNET_MT_HASH_SIZE + 1; j++) {
+		for (j = 0; j < (1 << mtable->mt_hash_bits) + 1; j++) {
 			while (!list_empty(&mhash[j])) {
 				me = list_entry(mhash[j].next,
 						struct lnet_me, me_list);
@@ -772,7 +841,8 @@ lnet_ptl_cleanup(struct lnet_portal *ptl)
 			}
 		}
 		/* the extra entry is for MEs with ignore bits */
-		LIBCFS_FREE(mhash, sizeof(*mhash) * (LNET_MT_HASH_SIZE + 1));
+		LIBCFS_FREE(mhash, sizeof(*mhash) *
+				   ((1 << mtable->mt_hash_bits) + 1));
 	}
 
 	cfs_percpt_free(ptl->ptl_mtables);
@@ -812,6 +882,7 @@ lnet_ptl_setup(struct lnet_portal *ptl, int index)
 		       sizeof(mtable->mt_exhausted[0]) *
 		       LNET_MT_EXHAUSTED_BMAP);
 		mtable->mt_mhash = mhash;
+		mtable->mt_hash_bits = LNET_MT_HASH_BITS;
 		for (j = 0; j < LNET_MT_HASH_SIZE + 1; j++)
 			INIT_LIST_HEAD(&mhash[j]);
 
@@ -1896,6 +1896,8 @@ struct cl_io {
 			     ci_noatime:1,
 	/* Tell sublayers not to expand LDLM locks requested for this IO */
 			     ci_lock_no_expand:1,
+	/* Only match LDLM locks already cached, never enqueue new ones */
+			     ci_lock_match:1,
 	/**
 	 * Set if non-delay RPC should be used for this IO.
 	 *
@@ -1909,7 +1911,14 @@ struct cl_io {
 	 * the read IO will check to-be-read OSCs' status, and make fast-switch
 	 * another mirror if some of the OSTs are not healthy.
 	 */
-			     ci_tried_all_mirrors:1;
+			     ci_tried_all_mirrors:1,
+	/**
+	 * Direct IO write whose iterations are not split at stripe
+	 * boundaries, so that ll_direct_IO() submits the pages of all the
+	 * stripes together and waits for them once, under the locks of all
+	 * the stripes.
+	 */
+			     ci_parallel_dio:1;
 	/**
 	 * Bypass quota check
 	 */
@@ -195,6 +195,12 @@ struct lu_target {
 	struct dt_object	*lut_reply_data;
 	/** Bitmap of used slots in the reply data file */
 	unsigned long		**lut_reply_bitmap;
+	/** Per-CPT caches of recently freed reply data slots */
+	struct tgt_reply_slot_cache **lut_reply_slot_cache;
+	/** reply data slot allocation stats */
+	atomic64_t		 lut_reply_slot_allocs;
+	atomic64_t		 lut_reply_slot_cached;
+	atomic64_t		 lut_reply_slot_ns;
 	/** target sync count, used for debug & test */
 	atomic_t		 lut_sync_count;
 
@@ -220,6 +226,20 @@ struct lu_target {
 #define LUT_REPLY_SLOTS_PER_CHUNK (1<<20)
 #define LUT_REPLY_SLOTS_MAX_CHUNKS 16
 
+/* number of freed reply data slots kept per CPT */
+#define LUT_REPLY_SLOT_CACHE_SIZE 64
+
+/**
+ * Recently freed reply data slots of one CPT. The slots stay marked used
+ * in lut_reply_bitmap while they are in the cache, so they are handed out
+ * again without scanning the bitmap.
+ */
+struct tgt_reply_slot_cache {
+	spinlock_t		rsc_lock;
+	int			rsc_count;
+	int			rsc_slots[LUT_REPLY_SLOT_CACHE_SIZE];
+};
+
 /**
  * Target reply data
  */
@@ -338,6 +338,12 @@ struct ldlm_ns_bucket {
 enum {
 	/** LDLM namespace lock stats */
 	LDLM_NSS_LOCKS          = 0,
+	/** blocking ASTs sent because of conflicting requests */
+	LDLM_NSS_BL_ASTS,
+	/** extent locks kept from expanding over another writer */
+	LDLM_NSS_EXPAND_LIMITED,
+	/** LRU updates which had to wait for ns_lock */
+	LDLM_NSS_LRU_CONTENDED,
 	LDLM_NSS_LAST
 };
 
@@ -509,6 +515,12 @@ struct ldlm_namespace {
 	/** Limit of parallel AST RPC count. */
 	unsigned		ns_max_parallel_ast;
 
+	/**
+	 * Whether extent locks are kept from expanding over the ranges other
+	 * clients are writing, based on their recent requests.
+	 */
+	unsigned int		ns_expand_pattern:1;
+
 	/**
 	 * Callback to check if a lock is good to be canceled by ELC or
 	 * during recovery.
@@ -651,6 +663,39 @@ struct ldlm_interval_tree {
 	struct interval_node	*lit_root; /* actual ldlm_interval */
 };
 
+/**
+ * Number of writers whose access pattern is remembered per extent resource.
+ */
+#define LDLM_EXTENT_HIST_SIZE	8
+
+/**
+ * Last write lock request of one client on an extent resource.
+ * The client is identified by the handle cookie of its export, which is
+ * never reused, so that no reference needs to be held on the export.
+ */
+struct ldlm_extent_hist_ent {
+	/** Export handle cookie of the client, 0 if the slot is unused */
+	__u64			lhe_exp_cookie;
+	/** Extent of the last request */
+	__u64			lhe_start;
+	__u64			lhe_end;
+	/** Distance between the starts of the last two requests */
+	__u64			lhe_stride;
+	/** When the last request was seen */
+	time64_t		lhe_time;
+};
+
+/**
+ * Access history of the writers of an extent resource, used on the server
+ * to avoid expanding a write lock over the range another client is writing.
+ * Protected by the resource lock.
+ */
+struct ldlm_extent_hist {
+	struct ldlm_extent_hist_ent	leh_ent[LDLM_EXTENT_HIST_SIZE];
+	/** Slot to be replaced next when the history is full */
+	unsigned int			leh_next;
+};
+
 /**
  * Lists of waiting locks for each inodebit type.
  * A lock can be in several liq_waiting lists and it remains in lr_waiting.
@@ -852,6 +897,11 @@ struct ldlm_lock {
 	 * Time, in nanoseconds, last used by e.g. being matched by lock match.
 	 */
 	ktime_t			l_last_used;
+	/**
+	 * Set when the lock was used while in the LRU, the lock is moved to
+	 * the LRU tail by the next LRU scan instead of by the user itself.
+	 */
+	bool			l_lru_touched;
 
 	/** Originally requested extent for the extent lock. */
 	struct ldlm_extent	l_req_extent;
@@ -1055,6 +1105,12 @@ struct ldlm_resource {
 		struct inode	*lr_lvb_inode;
 	};
 
+	/**
+	 * Access history of the writers (only for extent locks), used only
+	 * on server side and allocated on first use.
+	 */
+	struct ldlm_extent_hist	*lr_ext_hist;
+
 	/** Type of locks this resource can hold. Only one type per resource. */
 	enum ldlm_type		lr_type; /* LDLM_{PLAIN,EXTENT,FLOCK,IBITS} */
 
@@ -1068,6 +1124,11 @@ struct ldlm_resource {
 	void			*lr_lvb_data;
 	/** is lvb initialized ? */
 	bool			lr_lvb_initialized;
+	/**
+	 * A reprocessing of the waiting extent locks stopped at the first
+	 * blocked one, those behind it may be grantable. Protected by lr_lock.
+	 */
+	bool			lr_rescan_partial;
 
 	/** List of references to this resource. For debugging. */
 	struct lu_ref		lr_reference;
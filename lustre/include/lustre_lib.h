@@ -76,6 +76,7 @@ void target_destroy_export(struct obd_export *exp);
 void target_committed_to_req(struct ptlrpc_request *req);
 void target_cancel_recovery_timer(struct obd_device *obd);
 void target_stop_recovery_thread(struct obd_device *obd);
+bool target_recovery_task(struct obd_device *obd);
 void target_cleanup_recovery(struct obd_device *obd);
 int target_queue_recovery_request(struct ptlrpc_request *req,
                                   struct obd_device *obd);
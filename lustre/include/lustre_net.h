@@ -125,6 +125,12 @@
 
 #define PTLRPC_NTHRS_INIT	2
 
+/**
+ * Default # of seconds a service thread beyond the initial thread count
+ * can stay idle before it exits, 0 means threads are never retired.
+ */
+#define PTLRPC_THR_IDLE_TIMEOUT	300
+
 /**
  * Buffer Constants
  *
@@ -499,6 +505,11 @@
 #define OBD_MAX_SHORT_IO_BYTES	min(max(PAGE_SIZE, 16UL * 1024UL), \
 				    OST_SHORT_IO_SPACE & PAGE_MASK)
 
+/* Short i/o reads return the data in the reply, so unlike writes they are
+ * not bounded by the request buffer size. */
+#define OBD_MAX_SHORT_IO_READ_BYTES	max(OBD_MAX_SHORT_IO_BYTES, \
+					    64UL * 1024UL)
+
 #define OST_MAXREPSIZE		(9 * 1024)
 #define OST_IO_MAXREPSIZE	OST_MAXREPSIZE
 
@@ -1691,6 +1702,8 @@ struct ptlrpc_service {
 	int				srv_nthrs_cpt_init;
 	/** limit of threads number for each partition */
 	int				srv_nthrs_cpt_limit;
+	/** seconds before an idle surplus thread exits, 0 to disable */
+	int				srv_thr_idle_timeout;
 	/** Root of debugfs dir tree for this service */
 	struct dentry		       *srv_debugfs_entry;
         /** Pointer to statistic data for this service */
@@ -1774,6 +1787,10 @@ struct ptlrpc_service_part {
 	int				scp_nthrs_stopping;
 	/** # running threads */
 	int				scp_nthrs_running;
+	/** # threads exited because they were idle for too long */
+	int				scp_nthrs_retired;
+	/** last time a thread was added to this partition, in seconds */
+	time64_t			scp_thr_grow_time;
 	/** service threads list */
 	struct list_head		scp_threads;
 
@@ -1795,6 +1812,14 @@ struct ptlrpc_service_part {
 	int				scp_nreqs_incoming;
 	/** request buffers to be reposted */
 	struct list_head		scp_rqbd_idle;
+	/**
+	 * request buffers kept for reuse instead of being freed when
+	 * the partition has more posted than it needs, not counted in
+	 * scp_nrqbds_total and released by the rqbd shrinker
+	 */
+	struct list_head		scp_rqbd_spare;
+	/** # spare request buffers */
+	int				scp_nrqbds_spare;
 	/** req buffers receiving */
 	struct list_head		scp_rqbd_posted;
 	/** incoming reqs */
@@ -2216,6 +2241,7 @@ void *ptlrpcd_alloc_work(struct obd_import *imp,
                          int (*cb)(const struct lu_env *, void *), void *data);
 void ptlrpcd_destroy_work(void *handler);
 int ptlrpcd_queue_work(void *handler);
+void ptlrpcd_work_set_cpt(void *handler, int cpt);
 
 /** @} */
 struct ptlrpc_service_buf_conf {
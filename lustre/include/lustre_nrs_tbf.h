@@ -184,6 +184,18 @@ struct nrs_tbf_rule {
 	atomic_t			 tr_ref;
 	/** Generation of the rule. */
 	__u64				 tr_generation;
+	/** Parent rule, whose rate caps all the requests of this rule. */
+	struct nrs_tbf_rule		*tr_parent;
+	/** Number of started rules having this rule as parent. */
+	atomic_t			 tr_nchildren;
+	/**
+	 * Aggregate token bucket of a parent rule, shared by the clients of
+	 * the rule and of all its descendants. Protected by the request lock
+	 * of the service partition.
+	 */
+	__u64				 tr_ntoken;
+	/** Time check-point of the aggregate bucket. */
+	__u64				 tr_check_time;
 };
 
 struct nrs_tbf_ops {
@@ -313,6 +325,7 @@ struct nrs_tbf_cmd {
 			__u32			 ts_valid_type;
 			enum nrs_rule_flags	 ts_rule_flags;
 			char			*ts_next_name;
+			char			*ts_parent_name;
 		} tc_start;
 		struct nrs_tbf_cmd_change {
 			__u64			 tc_rpc_rate;
@@ -109,6 +109,8 @@ struct osc_device {
 		uint64_t	os_lockless_writes;    /* by bytes */
 		uint64_t	os_lockless_reads;     /* by bytes */
 		uint64_t	os_lockless_truncates; /* by times */
+		uint64_t	os_short_io_reads;     /* by RPCs */
+		uint64_t	os_short_io_writes;    /* by RPCs */
 	} od_stats;
 
 	/* configuration item(s) */
@@ -132,6 +134,8 @@ struct osc_io {
 			   oi_cap_sys_resource:1;
 	/** how many LRU pages are reserved for this IO */
 	unsigned long	   oi_lru_reserved;
+	/** how many dirty pages are reserved for the active extent */
+	unsigned long	   oi_dirty_reserved;
 
 	/** active extents, we know how many bytes is going to be written,
 	 * so having an active extent will prevent it from being fragmented */
@@ -606,6 +610,7 @@ int osc_cache_wait_range(const struct lu_env *env, struct osc_object *obj,
 			 pgoff_t start, pgoff_t end);
 int osc_io_unplug0(const struct lu_env *env, struct client_obd *cli,
 		   struct osc_object *osc, int async);
+void osc_dirty_unreserve(struct client_obd *cli, struct osc_io *oio);
 static inline void osc_wake_cache_waiters(struct client_obd *cli)
 {
 	wake_up(&cli->cl_cache_waiters);
@@ -196,6 +196,13 @@ struct client_obd {
 	 * Default value is 8K now.
 	 */
 	__u32			 cl_dom_min_inline_repsize;
+	/**
+	 * When the size of a DoM file being opened is known and not larger
+	 * than this value, the reply buffer is sized so the whole file can
+	 * be returned with the open. The buffer stays allocated while the
+	 * open request is kept for replay, so it is 0 (disabled) by default.
+	 */
+	__u32			 cl_dom_max_inline_repsize;
 
 	enum lustre_sec_part	 cl_sp_me;
 	enum lustre_sec_part	 cl_sp_to;
@@ -246,6 +253,8 @@ struct client_obd {
 	 * osc_object{}s are in the list.
 	 */
 	spinlock_t		cl_loi_list_lock;
+	/* how many times cl_loi_list_lock was found busy by the osc cache */
+	atomic_long_t		cl_loi_list_contended;
 	struct list_head	cl_loi_ready_list;
 	struct list_head	cl_loi_hp_ready_list;
 	struct list_head	cl_loi_write_list;
@@ -590,11 +599,23 @@ struct obd_notify_upcall {
         void *onu_owner;
 };
 
+#define TGT_LOCK_REPLAY_THREADS_MAX	32
+
 struct target_recovery_data {
 	svc_handler_t		trd_recovery_handler;
 	pid_t			trd_processing_task;
 	struct completion	trd_starting;
 	struct completion	trd_finishing;
+	/* parallel lock replay threads, valid during lock replay only */
+	int			trd_lock_replay_threads;
+	pid_t			trd_lock_replay_task[TGT_LOCK_REPLAY_THREADS_MAX];
+	/* # parallel lock replay threads which replayed some locks */
+	int			trd_lock_replay_workers;
+	/* time spent in each recovery stage, milliseconds */
+	__u64			trd_req_replay_ms;
+	__u64			trd_lock_replay_ms;
+	__u64			trd_final_ping_ms;
+	ktime_t			trd_final_ping_start;
 };
 
 struct obd_llog_group {
@@ -911,6 +932,9 @@ struct md_op_data {
 	bool			op_post_migrate;
 	/* used to access dir with bash hash */
 	__u32			op_stripe_index;
+
+	/* expected size of the file data to return with open, 0 if unknown */
+	__u64			op_dom_open_size;
 };
 
 struct md_callback {
@@ -684,6 +684,7 @@ extern char obd_jobid_var[];
 #define OBD_FAIL_OSP_RPCS_SEM			0x2104
 #define OBD_FAIL_OSP_CANT_PROCESS_LLOG		0x2105
 #define OBD_FAIL_OSP_INVALID_LOGID		0x2106
+#define OBD_FAIL_OSP_PRECREATE_DELAY		0x2107
 
 /* barrier */
 #define OBD_FAIL_MGS_BARRIER_READ_NET		0x2200
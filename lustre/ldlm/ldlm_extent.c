@@ -263,6 +263,105 @@ ldlm_extent_internal_policy_waiting(struct ldlm_lock *req,
         EXIT;
 }
 
+/**
+ * Limit the expansion of write lock \a req according to the recent write
+ * requests of other clients on the same resource, and record \a req in
+ * the access history of the resource.
+ *
+ * Without another writer the lock is expanded as usual. Otherwise it is not
+ * grown over the start of the range another client is writing above it, and
+ * not grown downwards at all, since writers are assumed to move forwards.
+ * A client writing its own region sequentially is granted up to its next
+ * expected request, instead of up to the next writer where it would be
+ * revoked on the first write of that client.
+ */
+static void ldlm_extent_internal_policy_pattern(struct ldlm_lock *req,
+						struct ldlm_extent *new_ex)
+{
+	struct ldlm_resource *res = req->l_resource;
+	struct ldlm_namespace *ns = ldlm_res_to_ns(res);
+	struct ldlm_extent_hist *hist = res->lr_ext_hist;
+	struct ldlm_extent_hist_ent *ent = NULL;
+	struct ldlm_extent_hist_ent *free = NULL;
+	struct ldlm_extent orig = *new_ex;
+	__u64 req_start = req->l_req_extent.start;
+	__u64 req_end = req->l_req_extent.end;
+	__u64 prev_end = 0;
+	time64_t now = ktime_get_seconds();
+	bool others = false;
+	bool below = false;
+	bool sequential;
+	__u64 cookie;
+	int i;
+
+	if (!ns->ns_expand_pattern || req->l_export == NULL ||
+	    !(req->l_req_mode & (LCK_PW | LCK_CW)))
+		return;
+
+	cookie = req->l_export->exp_handle.h_cookie;
+
+	if (hist == NULL) {
+		/* called under the resource lock */
+		OBD_ALLOC_GFP(hist, sizeof(*hist), GFP_ATOMIC);
+		if (hist == NULL)
+			return;
+		res->lr_ext_hist = hist;
+	}
+
+	for (i = 0; i < LDLM_EXTENT_HIST_SIZE; i++) {
+		struct ldlm_extent_hist_ent *e = &hist->leh_ent[i];
+
+		if (e->lhe_exp_cookie == cookie) {
+			ent = e;
+			continue;
+		}
+		if (e->lhe_exp_cookie == 0 ||
+		    e->lhe_time + ns->ns_contention_time < now) {
+			if (free == NULL)
+				free = e;
+			continue;
+		}
+		others = true;
+		if (e->lhe_start > req_end && e->lhe_start <= new_ex->end)
+			new_ex->end = e->lhe_start - 1;
+		if (e->lhe_end < req_start &&
+		    (!below || e->lhe_end > prev_end)) {
+			prev_end = e->lhe_end;
+			below = true;
+		}
+	}
+
+	/* moving forwards with no other writer in between */
+	sequential = ent != NULL && ent->lhe_end < req_start &&
+		     (!below || prev_end <= ent->lhe_end);
+
+	if (others) {
+		new_ex->start = max(new_ex->start, req_start);
+		if (sequential && ent->lhe_stride != 0 &&
+		    new_ex->end - req_end > ent->lhe_stride)
+			new_ex->end = req_end + ent->lhe_stride;
+		if (!ldlm_extent_equal(new_ex, &orig))
+			lprocfs_counter_incr(ns->ns_stats,
+					     LDLM_NSS_EXPAND_LIMITED);
+	}
+
+	if (ent == NULL) {
+		ent = free;
+		if (ent == NULL) {
+			ent = &hist->leh_ent[hist->leh_next];
+			hist->leh_next = (hist->leh_next + 1) %
+					 LDLM_EXTENT_HIST_SIZE;
+		}
+		ent->lhe_exp_cookie = cookie;
+		ent->lhe_stride = 0;
+	} else {
+		ent->lhe_stride = sequential ? req_start - ent->lhe_start : 0;
+	}
+	ent->lhe_start = req_start;
+	ent->lhe_end = req_end;
+	ent->lhe_time = now;
+}
+
 
 /* In order to determine the largest possible extent we can grant, we need
  * to scan all of the queues. */
@@ -290,6 +389,7 @@ static void ldlm_extent_policy(struct ldlm_resource *res,
 	 * LDLM_FL_LOCK_CHANGED, we must check for the NO_EXPANSION flag
 	 * in the lock flags rather than the 'flags' argument */
 	if (likely(!(lock->l_flags & LDLM_FL_NO_EXPANSION))) {
+		ldlm_extent_internal_policy_pattern(lock, &new_ex);
 		ldlm_extent_internal_policy_granted(lock, &new_ex);
 		ldlm_extent_internal_policy_waiting(lock, &new_ex);
 	} else {
@@ -853,6 +953,104 @@ int ldlm_process_extent_lock(struct ldlm_lock *lock, __u64 *flags,
 out_rpc_list:
 	RETURN(rc);
 }
+
+/**
+ * Check whether waiting lock \a pending could have been blocked by \a hint.
+ * Group locks conflict regardless of the extent.
+ */
+static inline bool ldlm_extent_hint_overlap(struct ldlm_lock *pending,
+					    struct ldlm_lock *hint)
+{
+	if (hint->l_req_mode == LCK_GROUP || pending->l_req_mode == LCK_GROUP)
+		return true;
+
+	return hint->l_policy_data.l_extent.start <=
+	       pending->l_req_extent.end &&
+	       hint->l_policy_data.l_extent.end >=
+	       pending->l_req_extent.start;
+}
+
+/**
+ * Iterate through the waiting extent locks of a resource and attempt to grant
+ * them.
+ *
+ * Without \a hint the queue is processed as by ldlm_reprocess_queue(), up to
+ * the first lock that can not be granted.
+ *
+ * When the reprocessing is caused by the release of \a hint, only the waiting
+ * locks overlapping it can have become grantable. All of them are checked and
+ * the others are skipped, which keeps reprocessing linear when many clients
+ * are waiting on disjoint extents of a shared object. A lock conflicting with
+ * an earlier waiting lock is still kept behind it by
+ * ldlm_extent_compat_queue(). This is only valid if no waiting lock was left
+ * grantable before, so after a pass which stopped early the next one checks
+ * the whole queue without stopping at blocked locks, and hinted passes are
+ * done again after that.
+ *
+ * Must be called with resource lock held.
+ */
+int ldlm_reprocess_extent_queue(struct ldlm_resource *res,
+				struct list_head *queue,
+				struct list_head *work_list,
+				enum ldlm_process_intention intention,
+				struct ldlm_lock *hint)
+{
+	struct ldlm_lock *pending, *next;
+	enum ldlm_error err;
+	__u64 flags;
+	bool full = false;
+	bool stopped = false;
+	int checked = 0;
+	int rc = LDLM_ITER_CONTINUE;
+
+	ENTRY;
+
+	check_res_locked(res);
+
+	LASSERT(res->lr_type == LDLM_EXTENT);
+	LASSERT(intention == LDLM_PROCESS_RESCAN ||
+		intention == LDLM_PROCESS_RECOVERY);
+
+	if (intention == LDLM_PROCESS_RECOVERY)
+		return ldlm_reprocess_queue(res, queue, work_list, intention,
+					    NULL);
+
+	if (res->lr_rescan_partial) {
+		hint = NULL;
+		full = true;
+	}
+
+	CDEBUG(D_DLMTRACE, "--- Reprocess resource "DLDLMRES" (%p)\n",
+	       PLDLMRES(res), res);
+
+	list_for_each_entry_safe(pending, next, queue, l_res_link) {
+		if (hint && !ldlm_extent_hint_overlap(pending, hint))
+			continue;
+
+		CDEBUG(D_INFO, "Reprocessing lock %p\n", pending);
+
+		/* no blocking ASTs are sent for LDLM_PROCESS_RESCAN */
+		flags = 0;
+		checked++;
+		rc = ldlm_process_extent_lock(pending, &flags, intention, &err,
+					      work_list);
+		if (rc != LDLM_ITER_CONTINUE && hint == NULL && !full) {
+			stopped = true;
+			break;
+		}
+	}
+
+	CDEBUG(D_DLMTRACE, "reprocessed %d waiting locks of "DLDLMRES
+	       ", %s\n", checked, PLDLMRES(res),
+	       hint != NULL ? "overlapping the released lock" :
+	       full ? "full rescan" : stopped ? "stopped early" : "all");
+
+	if (hint != NULL)
+		RETURN(LDLM_ITER_CONTINUE);
+
+	res->lr_rescan_partial = stopped;
+	RETURN(rc);
+}
 #endif /* HAVE_SERVER_SUPPORT */
 
 struct ldlm_kms_shift_args {
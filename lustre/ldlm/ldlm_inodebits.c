@@ -510,7 +510,7 @@ int ldlm_cli_inodebits_convert(struct ldlm_lock *lock,
 	 */
 	ldlm_clear_cbpending(lock);
 	ldlm_clear_bl_ast(lock);
-	spin_lock(&ns->ns_lock);
+	ldlm_ns_lru_lock(ns);
 	if (list_empty(&lock->l_lru))
 		ldlm_lock_add_to_lru_nolock(lock);
 	spin_unlock(&ns->ns_lock);
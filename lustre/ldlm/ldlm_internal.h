@@ -174,6 +174,16 @@ int ldlm_lock_remove_from_lru_check(struct ldlm_lock *lock, ktime_t last_use);
 #define ldlm_lock_remove_from_lru(lock) \
 		ldlm_lock_remove_from_lru_check(lock, ktime_set(0, 0))
 int ldlm_lock_remove_from_lru_nolock(struct ldlm_lock *lock);
+
+/* Take the LRU lock of \a ns, accounting for contention on it. */
+static inline void ldlm_ns_lru_lock(struct ldlm_namespace *ns)
+{
+	if (likely(spin_trylock(&ns->ns_lock)))
+		return;
+
+	lprocfs_counter_incr(ns->ns_stats, LDLM_NSS_LRU_CONTENDED);
+	spin_lock(&ns->ns_lock);
+}
 void ldlm_lock_add_to_lru_nolock(struct ldlm_lock *lock);
 void ldlm_lock_add_to_lru(struct ldlm_lock *lock);
 void ldlm_lock_touch_in_lru(struct ldlm_lock *lock);
@@ -190,6 +200,8 @@ int ldlm_bl_to_thread_list(struct ldlm_namespace *ns,
 			   struct ldlm_lock_desc *ld,
 			   struct list_head *cancels, int count,
 			   enum ldlm_cancel_flags cancel_flags);
+int ldlm_bl_cancel_pending(struct ldlm_namespace *ns, struct obd_export *exp,
+			   struct list_head *cancels, int max);
 int ldlm_bl_thread_wakeup(void);
 
 void ldlm_handle_bl_callback(struct ldlm_namespace *ns,
@@ -216,6 +228,11 @@ int ldlm_reprocess_inodebits_queue(struct ldlm_resource *res,
 int ldlm_process_extent_lock(struct ldlm_lock *lock, __u64 *flags,
 			     enum ldlm_process_intention intention,
 			     enum ldlm_error *err, struct list_head *work_list);
+int ldlm_reprocess_extent_queue(struct ldlm_resource *res,
+				struct list_head *queue,
+				struct list_head *work_list,
+				enum ldlm_process_intention intention,
+				struct ldlm_lock *hint);
 #endif
 int ldlm_extent_alloc_lock(struct ldlm_lock *lock);
 void ldlm_extent_add_lock(struct ldlm_resource *res, struct ldlm_lock *lock);
@@ -428,6 +445,7 @@ extern __u64 ldlm_lock_limit;
 extern __u64 ldlm_reclaim_threshold_mb;
 extern __u64 ldlm_lock_limit_mb;
 extern struct percpu_counter ldlm_granted_total;
+extern unsigned int ldlm_lock_fair_share;
 #endif
 int ldlm_reclaim_setup(void);
 void ldlm_reclaim_cleanup(void);
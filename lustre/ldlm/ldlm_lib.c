@@ -39,6 +39,7 @@
 
 #define DEBUG_SUBSYSTEM S_LDLM
 
+#include <linux/hash.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
 #include <linux/kthread.h>
@@ -2521,6 +2522,290 @@ abort:
 	} while (1);
 }
 
+/*
+ * Number of threads replaying locks in parallel during the second recovery
+ * stage, 0 means one per CPT.
+ */
+static unsigned int tgt_lock_replay_threads;
+module_param(tgt_lock_replay_threads, uint, 0644);
+MODULE_PARM_DESC(tgt_lock_replay_threads,
+		 "number of lock replay threads per target (0 = one per CPT)");
+
+/**
+ * Lock replay worker.
+ *
+ * Lock replays carry no transno and don't depend on each other, so unlike
+ * request replay they don't have to be handled one at a time. The recovery
+ * thread still takes them off obd_lock_replay_queue (and keeps watching for
+ * evictions and timeouts) but hands each of them to a worker picked by the
+ * resource hash, so all replays for one resource are handled in order by the
+ * same thread.
+ */
+struct target_lock_replay_worker {
+	struct lu_target	*lrw_lut;
+	int			 lrw_index;
+	int			 lrw_rc;
+	/* number of locks replayed by this worker */
+	int			 lrw_replayed;
+	struct ptlrpc_thread	 lrw_thread;
+	struct lu_env		 lrw_env;
+	/* protects lrw_queue and lrw_stopping */
+	spinlock_t		 lrw_lock;
+	struct list_head	 lrw_queue;
+	wait_queue_head_t	 lrw_waitq;
+	bool			 lrw_stopping;
+	struct completion	 lrw_started;
+	struct completion	 lrw_finished;
+};
+
+/**
+ * Whether the current task processes recovery requests of \a obd, i.e. it is
+ * the recovery thread or one of its lock replay workers.
+ */
+bool target_recovery_task(struct obd_device *obd)
+{
+	struct target_recovery_data *trd = &obd->obd_recovery_data;
+	pid_t pid = current_pid();
+	int i;
+
+	if (trd->trd_processing_task == pid)
+		return true;
+
+	for (i = 0; i < trd->trd_lock_replay_threads; i++)
+		if (trd->trd_lock_replay_task[i] == pid)
+			return true;
+
+	return false;
+}
+EXPORT_SYMBOL(target_recovery_task);
+
+static bool target_lock_replay_wait(struct target_lock_replay_worker *lrw)
+{
+	bool rc;
+
+	spin_lock(&lrw->lrw_lock);
+	rc = !list_empty(&lrw->lrw_queue) || lrw->lrw_stopping;
+	spin_unlock(&lrw->lrw_lock);
+
+	return rc;
+}
+
+static int target_lock_replay_thread(void *arg)
+{
+	struct target_lock_replay_worker *lrw = arg;
+	struct obd_device *obd = lrw->lrw_lut->lut_obd;
+	struct target_recovery_data *trd = &obd->obd_recovery_data;
+	struct ptlrpc_thread *thread = &lrw->lrw_thread;
+	struct lu_env *env = &lrw->lrw_env;
+	struct ptlrpc_request *req;
+	struct l_wait_info lwi = { 0 };
+	int rc;
+	ENTRY;
+
+	unshare_fs_struct();
+	rc = cfs_cpt_bind(cfs_cpt_table,
+			  lrw->lrw_index % cfs_cpt_number(cfs_cpt_table));
+	if (rc)
+		CDEBUG(D_HA, "%s: lock replay thread %d not bound: rc = %d\n",
+		       obd->obd_name, lrw->lrw_index, rc);
+
+	rc = lu_env_add(env);
+	if (rc)
+		GOTO(out, rc);
+
+	rc = lu_context_init(&env->le_ctx, LCT_MD_THREAD | LCT_DT_THREAD);
+	if (rc)
+		GOTO(out_env_remove, rc);
+
+	thread->t_env = env;
+	thread->t_id = -1; /* force filter_iobuf_get/put to use local buffers */
+	env->le_ctx.lc_thread = thread;
+	tgt_io_thread_init(thread);
+	thread->t_watchdog = NULL;
+
+	trd->trd_lock_replay_task[lrw->lrw_index] = current_pid();
+	complete(&lrw->lrw_started);
+
+	while (1) {
+		l_wait_event(lrw->lrw_waitq, target_lock_replay_wait(lrw),
+			     &lwi);
+
+		spin_lock(&lrw->lrw_lock);
+		if (list_empty(&lrw->lrw_queue)) {
+			spin_unlock(&lrw->lrw_lock);
+			/* only stopping with nothing left to replay */
+			break;
+		}
+		req = list_entry(lrw->lrw_queue.next, struct ptlrpc_request,
+				 rq_list);
+		list_del_init(&req->rq_list);
+		spin_unlock(&lrw->lrw_lock);
+
+		DEBUG_REQ(D_HA, req, "processing lock from %s: ",
+			  libcfs_nid2str(req->rq_peer.nid));
+		handle_recovery_req(thread, req, trd->trd_recovery_handler);
+		target_request_copy_put(req);
+		lrw->lrw_replayed++;
+	}
+
+	trd->trd_lock_replay_task[lrw->lrw_index] = 0;
+	tgt_io_thread_done(thread);
+	lu_context_fini(&env->le_ctx);
+out_env_remove:
+	lu_env_remove(env);
+out:
+	lrw->lrw_rc = rc;
+	if (rc != 0)
+		complete(&lrw->lrw_started);
+	complete(&lrw->lrw_finished);
+	RETURN(rc);
+}
+
+/**
+ * Start the lock replay workers of \a lut.
+ *
+ * \retval number of workers started, 0 if locks are to be replayed by the
+ *	   recovery thread itself
+ */
+static int target_lock_replay_start(struct lu_target *lut,
+				    struct target_lock_replay_worker **workers)
+{
+	struct obd_device *obd = lut->lut_obd;
+	struct target_recovery_data *trd = &obd->obd_recovery_data;
+	struct target_lock_replay_worker *lrw;
+	struct task_struct *task;
+	int count = tgt_lock_replay_threads;
+	int index;
+	int i;
+	ENTRY;
+
+	if (count == 0)
+		count = cfs_cpt_number(cfs_cpt_table);
+	count = min(count, TGT_LOCK_REPLAY_THREADS_MAX);
+	if (count <= 1)
+		RETURN(0);
+
+	if (server_name2index(obd->obd_name, &index, NULL) < 0)
+		RETURN(0);
+
+	OBD_ALLOC(lrw, count * sizeof(*lrw));
+	if (lrw == NULL)
+		RETURN(0);
+
+	for (i = 0; i < count; i++) {
+		lrw[i].lrw_lut = lut;
+		lrw[i].lrw_index = i;
+		spin_lock_init(&lrw[i].lrw_lock);
+		INIT_LIST_HEAD(&lrw[i].lrw_queue);
+		init_waitqueue_head(&lrw[i].lrw_waitq);
+		init_completion(&lrw[i].lrw_started);
+		init_completion(&lrw[i].lrw_finished);
+	}
+
+	trd->trd_lock_replay_threads = count;
+	for (i = 0; i < count; i++) {
+		task = kthread_run(target_lock_replay_thread, &lrw[i],
+				   "tgt_lockrep_%d_%02d", index, i);
+		if (IS_ERR(task)) {
+			lrw[i].lrw_rc = PTR_ERR(task);
+			complete(&lrw[i].lrw_finished);
+			break;
+		}
+		wait_for_completion(&lrw[i].lrw_started);
+		if (lrw[i].lrw_rc != 0)
+			break;
+	}
+
+	if (i < count) {
+		int started = i;
+
+		CWARN("%s: cannot start lock replay thread %d, replaying locks serially: rc = %d\n",
+		      obd->obd_name, i, lrw[i].lrw_rc);
+		for (i = 0; i < started; i++) {
+			spin_lock(&lrw[i].lrw_lock);
+			lrw[i].lrw_stopping = true;
+			spin_unlock(&lrw[i].lrw_lock);
+			wake_up(&lrw[i].lrw_waitq);
+			wait_for_completion(&lrw[i].lrw_finished);
+		}
+		trd->trd_lock_replay_threads = 0;
+		OBD_FREE(lrw, count * sizeof(*lrw));
+		RETURN(0);
+	}
+
+	*workers = lrw;
+	RETURN(count);
+}
+
+/**
+ * Pass a lock replay request to the worker handling its resource.
+ */
+static void target_lock_replay_queue(struct target_lock_replay_worker *lrw,
+				     int count, struct ptlrpc_request *req)
+{
+	struct ldlm_request *dlm_req;
+	__u64 key = (unsigned long)req->rq_export;
+
+	if (lustre_msg_get_opc(req->rq_reqmsg) == LDLM_ENQUEUE) {
+		dlm_req = lustre_msg_buf(req->rq_reqmsg, DLM_LOCKREQ_OFF,
+					 sizeof(*dlm_req));
+		if (dlm_req != NULL) {
+			struct ldlm_res_id *name =
+				&dlm_req->lock_desc.l_resource.lr_name;
+			__u64 seq = name->name[0];
+			__u64 oid = name->name[1];
+
+			if (ptlrpc_req_need_swab(req)) {
+				__swab64s(&seq);
+				__swab64s(&oid);
+			}
+			/* both parts of a FID, or of an OST object id, as in
+			 * ldlm_res_hop_hash() */
+			key = seq + oid;
+		}
+	}
+
+	lrw += hash_64(key, 32) % count;
+	spin_lock(&lrw->lrw_lock);
+	list_add_tail(&req->rq_list, &lrw->lrw_queue);
+	spin_unlock(&lrw->lrw_lock);
+	wake_up(&lrw->lrw_waitq);
+}
+
+/**
+ * Wait for the lock replay workers to drain their queues and stop them.
+ *
+ * \retval number of locks replayed by the workers
+ */
+static int target_lock_replay_stop(struct obd_device *obd,
+				   struct target_lock_replay_worker *lrw,
+				   int count)
+{
+	int replayed = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		spin_lock(&lrw[i].lrw_lock);
+		lrw[i].lrw_stopping = true;
+		spin_unlock(&lrw[i].lrw_lock);
+		wake_up(&lrw[i].lrw_waitq);
+	}
+
+	for (i = 0; i < count; i++) {
+		wait_for_completion(&lrw[i].lrw_finished);
+		CDEBUG(D_HA, "%s: lock replay thread %d replayed %d locks\n",
+		       obd->obd_name, i, lrw[i].lrw_replayed);
+		if (lrw[i].lrw_replayed > 0)
+			obd->obd_recovery_data.trd_lock_replay_workers++;
+		replayed += lrw[i].lrw_replayed;
+	}
+
+	obd->obd_recovery_data.trd_lock_replay_threads = 0;
+	OBD_FREE(lrw, count * sizeof(*lrw));
+
+	return replayed;
+}
+
 static int target_recovery_thread(void *arg)
 {
         struct lu_target *lut = arg;
@@ -2530,6 +2815,9 @@ static int target_recovery_thread(void *arg)
         unsigned long delta;
         struct lu_env *env;
         struct ptlrpc_thread *thread = NULL;
+	struct target_lock_replay_worker *workers = NULL;
+	int nr_workers;
+	ktime_t stage_start;
         int rc = 0;
         ENTRY;
 
@@ -2578,15 +2866,23 @@ static int target_recovery_thread(void *arg)
 	CDEBUG(D_INFO, "1: request replay stage - %d clients from t%llu\n",
 	       atomic_read(&obd->obd_req_replay_clients),
 	       obd->obd_next_recovery_transno);
+	stage_start = ktime_get();
 	replay_request_or_update(env, lut, trd, thread);
+	trd->trd_req_replay_ms = ktime_ms_delta(ktime_get(), stage_start);
 
 	/**
 	 * The second stage: replay locks
 	 */
 	CDEBUG(D_INFO, "2: lock replay stage - %d clients\n",
 	       atomic_read(&obd->obd_lock_replay_clients));
+	stage_start = ktime_get();
+	nr_workers = target_lock_replay_start(lut, &workers);
 	while ((req = target_next_replay_lock(lut))) {
 		LASSERT(trd->trd_processing_task == current_pid());
+		if (nr_workers > 0) {
+			target_lock_replay_queue(workers, nr_workers, req);
+			continue;
+		}
 		DEBUG_REQ(D_HA, req, "processing lock from %s: ",
 			  libcfs_nid2str(req->rq_peer.nid));
 		handle_recovery_req(thread, req,
@@ -2594,6 +2890,10 @@ static int target_recovery_thread(void *arg)
 		target_request_copy_put(req);
 		obd->obd_replayed_locks++;
 	}
+	if (nr_workers > 0)
+		obd->obd_replayed_locks += target_lock_replay_stop(obd, workers,
+								   nr_workers);
+	trd->trd_lock_replay_ms = ktime_ms_delta(ktime_get(), stage_start);
 
         /**
          * The third stage: reply on final pings, at this moment all clients
@@ -2601,6 +2901,7 @@ static int target_recovery_thread(void *arg)
          */
 	CFS_FAIL_TIMEOUT(OBD_FAIL_TGT_REPLAY_RECONNECT, cfs_fail_val);
         CDEBUG(D_INFO, "3: final stage - process recovery completion pings\n");
+	trd->trd_final_ping_start = ktime_get();
         /** Update server last boot epoch */
         tgt_boot_epoch_update(lut);
         /* We drop recoverying flag to forward all new requests
@@ -2623,10 +2924,14 @@ static int target_recovery_thread(void *arg)
 		ptlrpc_update_export_timer(req->rq_export, 0);
 		target_request_copy_put(req);
 	}
+	trd->trd_final_ping_ms = ktime_ms_delta(ktime_get(),
+						trd->trd_final_ping_start);
 
 	delta = jiffies_to_msecs(jiffies - delta) / MSEC_PER_SEC;
-	CDEBUG(D_INFO,"4: recovery completed in %lus - %d/%d reqs/locks\n",
-	      delta, obd->obd_replayed_requests, obd->obd_replayed_locks);
+	CDEBUG(D_INFO, "4: recovery completed in %lus - %d/%d reqs/locks, stages %llu/%llu/%llums\n",
+	       delta, obd->obd_replayed_requests, obd->obd_replayed_locks,
+	       trd->trd_req_replay_ms, trd->trd_lock_replay_ms,
+	       trd->trd_final_ping_ms);
 	if (delta > OBD_RECOVERY_TIME_SOFT) {
 		CWARN("too long recovery - read logs\n");
 		libcfs_debug_dumplog();
@@ -2789,7 +3094,7 @@ int target_queue_recovery_request(struct ptlrpc_request *req,
 	int inserted = 0;
 	ENTRY;
 
-	if (obd->obd_recovery_data.trd_processing_task == current_pid()) {
+	if (target_recovery_task(obd)) {
 		/* Processing the queue right now, don't re-add. */
 		RETURN(1);
 	}
@@ -2974,6 +3279,45 @@ void target_committed_to_req(struct ptlrpc_request *req)
                exp->exp_last_committed, req->rq_transno, req->rq_xid);
 }
 
+/* How far the lock volume of one client may be moved from the SLV. */
+#define TGT_POOL_SLV_SHRINK_MAX	16
+#define TGT_POOL_SLV_GROW_MAX	2
+
+/**
+ * Returns the lock volume to send to the client of \a exp.
+ *
+ * The SLV of the pool drops for all clients as the number of granted locks
+ * approaches the limit, however only some of them may be holding most of
+ * the locks. A client holding more locks than its share of the pool limit
+ * gets a lower volume and cancels more of its locks, and a client holding
+ * less than half of its share gets a higher one and keeps its cache.
+ */
+static __u64 target_pool_export_slv(struct obd_export *exp, __u64 slv,
+				    int limit)
+{
+	int nr = exp->exp_obd->obd_num_exports;
+	__u64 locks = atomic_read(&exp->exp_locks_count);
+	__u64 share;
+
+	if (!ldlm_lock_fair_share || nr <= 1 || limit <= 0 || slv == 0)
+		return slv;
+
+	share = max(limit / nr, 1);
+	if (locks > share) {
+		locks = min_t(__u64, locks, share * TGT_POOL_SLV_SHRINK_MAX);
+		if (slv < U64_MAX / share)
+			slv = div64_u64(slv * share, locks);
+		else
+			slv = div64_u64(slv, locks) * share;
+		slv = max_t(__u64, slv, 1);
+	} else if (locks < share / 2 &&
+		   slv < U64_MAX / TGT_POOL_SLV_GROW_MAX) {
+		slv *= TGT_POOL_SLV_GROW_MAX;
+	}
+
+	return slv;
+}
+
 #endif /* HAVE_SERVER_SUPPORT */
 
 /**
@@ -2997,7 +3341,14 @@ int target_pack_pool_reply(struct ptlrpc_request *req)
         obd = req->rq_export->exp_obd;
 
 	read_lock(&obd->obd_pool_lock);
+#ifdef HAVE_SERVER_SUPPORT
+	lustre_msg_set_slv(req->rq_repmsg,
+			   target_pool_export_slv(req->rq_export,
+						  obd->obd_pool_slv,
+						  obd->obd_pool_limit));
+#else
         lustre_msg_set_slv(req->rq_repmsg, obd->obd_pool_slv);
+#endif
         lustre_msg_set_limit(req->rq_repmsg, obd->obd_pool_limit);
 	read_unlock(&obd->obd_pool_lock);
 
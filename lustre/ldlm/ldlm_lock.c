@@ -154,7 +154,7 @@ EXPORT_SYMBOL(ldlm_get_processing_policy);
 
 static ldlm_reprocessing_policy ldlm_reprocessing_policy_table[] = {
 	[LDLM_PLAIN]	= ldlm_reprocess_queue,
-	[LDLM_EXTENT]	= ldlm_reprocess_queue,
+	[LDLM_EXTENT]	= ldlm_reprocess_extent_queue,
 	[LDLM_FLOCK]	= ldlm_reprocess_queue,
 	[LDLM_IBITS]	= ldlm_reprocess_inodebits_queue,
 };
@@ -285,7 +285,7 @@ int ldlm_lock_remove_from_lru_check(struct ldlm_lock *lock, ktime_t last_use)
 		RETURN(0);
 	}
 
-	spin_lock(&ns->ns_lock);
+	ldlm_ns_lru_lock(ns);
 	if (!ktime_compare(last_use, ktime_set(0, 0)) ||
 	    !ktime_compare(last_use, lock->l_last_used))
 		rc = ldlm_lock_remove_from_lru_nolock(lock);
@@ -302,6 +302,7 @@ void ldlm_lock_add_to_lru_nolock(struct ldlm_lock *lock)
 	struct ldlm_namespace *ns = ldlm_lock_to_ns(lock);
 
 	lock->l_last_used = ktime_get();
+	lock->l_lru_touched = false;
 	LASSERT(list_empty(&lock->l_lru));
 	LASSERT(lock->l_resource->lr_type != LDLM_FLOCK);
 	list_add_tail(&lock->l_lru, &ns->ns_unused_list);
@@ -318,20 +319,22 @@ void ldlm_lock_add_to_lru(struct ldlm_lock *lock)
 	struct ldlm_namespace *ns = ldlm_lock_to_ns(lock);
 
 	ENTRY;
-	spin_lock(&ns->ns_lock);
+	ldlm_ns_lru_lock(ns);
 	ldlm_lock_add_to_lru_nolock(lock);
 	spin_unlock(&ns->ns_lock);
 	EXIT;
 }
 
 /**
- * Moves LDLM lock \a lock that is already in namespace LRU to the tail of
- * the LRU. Performs necessary LRU locking
+ * Marks LDLM lock \a lock that is already in namespace LRU as just used.
+ *
+ * The lock is moved to the tail of the LRU by the next LRU scan in
+ * ldlm_prepare_lru_list(), so that matching a cached lock does not need
+ * ns_lock. Must be called with the lock locked, which keeps it from being
+ * added to the LRU meanwhile.
  */
 void ldlm_lock_touch_in_lru(struct ldlm_lock *lock)
 {
-	struct ldlm_namespace *ns = ldlm_lock_to_ns(lock);
-
 	ENTRY;
 	if (ldlm_is_ns_srv(lock)) {
 		LASSERT(list_empty(&lock->l_lru));
@@ -339,12 +342,12 @@ void ldlm_lock_touch_in_lru(struct ldlm_lock *lock)
 		return;
 	}
 
-	spin_lock(&ns->ns_lock);
+	/* The LRU scan may remove the lock from the LRU meanwhile, the flag
+	 * is reset when it is added again. */
 	if (!list_empty(&lock->l_lru)) {
-		ldlm_lock_remove_from_lru_nolock(lock);
-		ldlm_lock_add_to_lru_nolock(lock);
+		lock->l_last_used = ktime_get();
+		lock->l_lru_touched = true;
 	}
-	spin_unlock(&ns->ns_lock);
 	EXIT;
 }
 
@@ -680,6 +683,8 @@ static void ldlm_add_bl_work_item(struct ldlm_lock *lock, struct ldlm_lock *new,
 	if (!ldlm_is_ast_sent(lock)) {
 		LDLM_DEBUG(lock, "lock incompatible; sending blocking AST.");
 		ldlm_set_ast_sent(lock);
+		lprocfs_counter_incr(ldlm_lock_to_ns(lock)->ns_stats,
+				     LDLM_NSS_BL_ASTS);
 		/* If the enqueuing client said so, tell the AST recipient to
 		 * discard dirty data, rather than writing back. */
 		if (ldlm_is_ast_discard_data(new))
@@ -758,7 +763,10 @@ EXPORT_SYMBOL(ldlm_lock_addref);
 void ldlm_lock_addref_internal_nolock(struct ldlm_lock *lock,
 				      enum ldlm_mode mode)
 {
-        ldlm_lock_remove_from_lru(lock);
+	/* The lock can only be added to the LRU with the lock locked, no need
+	 * to take ns_lock for a lock which is not there. */
+	if (!list_empty(&lock->l_lru))
+		ldlm_lock_remove_from_lru(lock);
         if (mode & (LCK_NL | LCK_CR | LCK_PR)) {
                 lock->l_readers++;
                 lu_ref_add_atomic(&lock->l_reference, "reader", lock);
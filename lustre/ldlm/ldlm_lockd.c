@@ -1604,8 +1604,8 @@ int ldlm_request_cancel(struct ptlrpc_request *req,
 			int first, enum lustre_at_flags flags)
 {
 	struct ldlm_resource *res, *pres = NULL;
-	struct ldlm_lock *lock;
-	int i, count, done = 0;
+	struct ldlm_lock *lock, *hint = NULL;
+	int i, count, done = 0, pdone = 0;
 	unsigned int size;
 
 	ENTRY;
@@ -1648,11 +1648,18 @@ int ldlm_request_cancel(struct ptlrpc_request *req,
 		 * after we are done cancelling lock in that resource.
 		 */
 		if (res != pres) {
+			/* if a single lock was cancelled in the resource, only
+			 * the locks waiting for it need to be reprocessed */
 			if (pres != NULL) {
-				ldlm_reprocess_all(pres, NULL);
+				ldlm_reprocess_all(pres,
+						   pdone == 1 ? hint : NULL);
 				LDLM_RESOURCE_DELREF(pres);
 				ldlm_resource_putref(pres);
 			}
+			if (hint != NULL)
+				LDLM_LOCK_RELEASE(hint);
+			hint = LDLM_LOCK_GET(lock);
+			pdone = 0;
 			if (res != NULL) {
 				ldlm_resource_getref(res);
 				LDLM_RESOURCE_ADDREF(res);
@@ -1663,6 +1670,7 @@ int ldlm_request_cancel(struct ptlrpc_request *req,
 			}
 			pres = res;
 		}
+		pdone++;
 
 		if ((flags & LATF_STATS) && ldlm_is_ast_sent(lock) &&
 		    lock->l_blast_sent != 0) {
@@ -1676,10 +1684,12 @@ int ldlm_request_cancel(struct ptlrpc_request *req,
 		LDLM_LOCK_PUT(lock);
 	}
 	if (pres != NULL) {
-		ldlm_reprocess_all(pres, NULL);
+		ldlm_reprocess_all(pres, pdone == 1 ? hint : NULL);
 		LDLM_RESOURCE_DELREF(pres);
 		ldlm_resource_putref(pres);
 	}
+	if (hint != NULL)
+		LDLM_LOCK_RELEASE(hint);
 	LDLM_DEBUG_NOLOCK("server-side cancel handler END");
 	RETURN(done);
 }
@@ -2113,6 +2123,126 @@ int ldlm_bl_to_thread_list(struct ldlm_namespace *ns, struct ldlm_lock_desc *ld,
 	return ldlm_bl_to_thread(ns, ld, NULL, cancels, count, cancel_flags);
 }
 
+/**
+ * Move the blocking ASTs for extent locks of \a ns held through \a exp from
+ * the bl queue \a queue to \a work, at most \a max of them.
+ * Called with blp_lock held.
+ *
+ * \retval number of work items moved
+ */
+static int ldlm_bl_take_pending(struct list_head *queue,
+				struct ldlm_namespace *ns,
+				struct obd_export *exp,
+				struct list_head *work, int max,
+				bool *mem_pressure)
+{
+	struct ldlm_bl_work_item *blwi, *tmp;
+	int taken = 0;
+
+	list_for_each_entry_safe(blwi, tmp, queue, blwi_entry) {
+		struct ldlm_lock *lock = blwi->blwi_lock;
+
+		if (taken >= max)
+			break;
+		if (blwi->blwi_ns != ns || blwi->blwi_count != 0 ||
+		    lock == NULL || !(blwi->blwi_flags & LCF_ASYNC) ||
+		    lock->l_conn_export != exp ||
+		    lock->l_resource->lr_type != LDLM_EXTENT)
+			continue;
+		if (blwi->blwi_mem_pressure)
+			*mem_pressure = true;
+		list_move_tail(&blwi->blwi_entry, work);
+		taken++;
+	}
+
+	return taken;
+}
+
+/**
+ * Pick up blocking ASTs still queued for the bl threads for extent locks of
+ * \a ns held through \a exp, and cancel those locks locally so that they
+ * can be sent together with a lock cancel already in progress.
+ *
+ * A server revoking many locks of one client (e.g. a whole file being
+ * truncated or written by another client) sends one blocking AST per lock,
+ * each of which would otherwise end in its own LDLM_CANCEL RPC.
+ *
+ * The locks to be discarded on blp_prio_list are taken first. Those on
+ * blp_list may have dirty pages to flush here, so they are left to the bl
+ * threads while prioritized work is queued, not to hold it up. The locks
+ * are cancelled under memory pressure if any of their blocking ASTs was
+ * queued under it, as the bl thread would have done.
+ *
+ * Locks that are still in use are only marked CBPENDING, as the bl thread
+ * would have done; they are cancelled on their last dereference.
+ *
+ * \retval number of locks added to \a cancels
+ */
+int ldlm_bl_cancel_pending(struct ldlm_namespace *ns, struct obd_export *exp,
+			   struct list_head *cancels, int max)
+{
+	struct ldlm_bl_pool *blp = ldlm_state->ldlm_bl_pool;
+	struct ldlm_bl_work_item *blwi, *tmp;
+	struct list_head work = LIST_HEAD_INIT(work);
+	struct list_head head = LIST_HEAD_INIT(head);
+	bool mem_pressure = false;
+	int taken, count = 0;
+	ENTRY;
+
+	if (max <= 0)
+		RETURN(0);
+
+	spin_lock(&blp->blp_lock);
+	taken = ldlm_bl_take_pending(&blp->blp_prio_list, ns, exp, &work, max,
+				     &mem_pressure);
+	if (list_empty(&blp->blp_prio_list))
+		taken += ldlm_bl_take_pending(&blp->blp_list, ns, exp, &work,
+					      max - taken, &mem_pressure);
+	spin_unlock(&blp->blp_lock);
+
+	list_for_each_entry_safe(blwi, tmp, &work, blwi_entry) {
+		struct ldlm_lock *lock = blwi->blwi_lock;
+		bool unused;
+
+		list_del_init(&blwi->blwi_entry);
+
+		lock_res_and_lock(lock);
+		ldlm_bl_desc2lock(&blwi->blwi_ld, lock);
+		ldlm_set_cbpending(lock);
+		if (ldlm_is_cancel_on_block(lock))
+			ldlm_set_cancel(lock);
+		unused = !lock->l_readers && !lock->l_writers &&
+			 !ldlm_is_canceling(lock);
+		if (unused)
+			ldlm_set_canceling(lock);
+		unlock_res_and_lock(lock);
+
+		if (unused) {
+			LDLM_DEBUG(lock, "batched with a pending cancel");
+			LASSERT(list_empty(&lock->l_bl_ast));
+			/* the blwi reference is dropped by the cancel list */
+			list_add(&lock->l_bl_ast, &head);
+			count++;
+		} else {
+			LDLM_LOCK_RELEASE(lock);
+		}
+		OBD_FREE(blwi, sizeof(*blwi));
+	}
+
+	if (count > 0) {
+		int mpflag = 0;
+
+		if (mem_pressure)
+			mpflag = cfs_memory_pressure_get_and_set();
+		count = ldlm_cli_cancel_list_local(&head, count, LCF_BL_AST);
+		if (mem_pressure)
+			cfs_memory_pressure_restore(mpflag);
+		list_splice(&head, cancels);
+	}
+
+	RETURN(count);
+}
+
 int ldlm_bl_thread_wakeup(void)
 {
 	wake_up(&ldlm_state->ldlm_bl_pool->blp_waitq);
@@ -62,6 +62,10 @@ __u64 ldlm_reclaim_threshold_mb;
 __u64 ldlm_lock_limit_mb;
 
 struct percpu_counter		ldlm_granted_total;
+/* Reclaim locks from the exports holding more than their share first, and
+ * scale the lock volume sent to each client by its share of the locks, see
+ * target_pool_export_slv(). */
+unsigned int			ldlm_lock_fair_share = 1;
 static atomic_t			ldlm_nr_reclaimer;
 static s64			ldlm_last_reclaim_age_ns;
 static ktime_t			ldlm_last_reclaim_time;
@@ -74,6 +78,8 @@ struct ldlm_reclaim_cb_data {
 	int			 rcd_start;
 	bool			 rcd_skip;
 	s64			 rcd_age_ns;
+	/* only revoke locks of exports holding more locks than this */
+	int			 rcd_heavy;
 	struct cfs_hash_bd	*rcd_prev_bd;
 };
 
@@ -142,6 +148,11 @@ static int ldlm_reclaim_lock_cb(struct cfs_hash *hs, struct cfs_hash_bd *bd,
 		if (!ldlm_lock_reclaimable(lock))
 			continue;
 
+		if (data->rcd_heavy && lock->l_export != NULL &&
+		    atomic_read(&lock->l_export->exp_locks_count) <=
+		    data->rcd_heavy)
+			continue;
+
 		if (!OBD_FAIL_CHECK(OBD_FAIL_LDLM_WATERMARK_LOW) &&
 		    ktime_before(ktime_get(),
 				 ktime_add_ns(lock->l_last_used,
@@ -174,10 +185,12 @@ static int ldlm_reclaim_lock_cb(struct cfs_hash *hs, struct cfs_hash_bd *bd,
  * \param[in] skip	scan from the first lock on resource if the
  *			'skip' is false, otherwise, continue scan
  *			from the last scanned position
+ * \param[in] heavy	only revoke locks of the exports holding more
+ *			locks than the average export of the namespace
  * \param[out] count	count of lock still to be revoked
  */
 static void ldlm_reclaim_res(struct ldlm_namespace *ns, int *count,
-			     s64 age_ns, bool skip)
+			     s64 age_ns, bool skip, bool heavy)
 {
 	struct ldlm_reclaim_cb_data	data;
 	int				idx, type, start;
@@ -204,6 +217,10 @@ static void ldlm_reclaim_res(struct ldlm_namespace *ns, int *count,
 	data.rcd_age_ns = age_ns;
 	data.rcd_skip = skip;
 	data.rcd_prev_bd = NULL;
+	data.rcd_heavy = 0;
+	if (heavy && ns->ns_obd && ns->ns_obd->obd_num_exports > 1)
+		data.rcd_heavy = max(atomic_read(&ns->ns_pool.pl_granted) /
+				     ns->ns_obd->obd_num_exports, 1);
 	start = ns->ns_reclaim_start % CFS_HASH_NBKT(ns->ns_rs_hash);
 
 	cfs_hash_for_each_nolock(ns->ns_rs_hash, ldlm_reclaim_lock_cb, &data,
@@ -253,6 +270,7 @@ static void ldlm_reclaim_ns(void)
 	enum ldlm_side		 ns_cli = LDLM_NAMESPACE_SERVER;
 	s64 age_ns;
 	bool			 skip = true;
+	bool			 heavy = ldlm_lock_fair_share;
 	ENTRY;
 
 	if (!atomic_add_unless(&ldlm_nr_reclaimer, 1, 1)) {
@@ -276,11 +294,17 @@ again:
 		ldlm_namespace_move_to_active_locked(ns, ns_cli);
 		mutex_unlock(ldlm_namespace_lock(ns_cli));
 
-		ldlm_reclaim_res(ns, &count, age_ns, skip);
+		ldlm_reclaim_res(ns, &count, age_ns, skip, heavy);
 		ldlm_namespace_put(ns);
 		nr_processed++;
 	}
 
+	/* not enough old locks on the heaviest exports, revoke from all */
+	if (count > 0 && heavy) {
+		heavy = false;
+		goto again;
+	}
+
 	if (count > 0 && age_ns > LDLM_RECLAIM_AGE_MIN) {
 		age_ns >>= 1;
 		if (age_ns < (LDLM_RECLAIM_AGE_MIN * 2))
@@ -1457,10 +1457,17 @@ int ldlm_cli_cancel(const struct lustre_handle *lockh,
 		LASSERT(avail > 0);
 
 		ns = ldlm_lock_to_ns(lock);
+		/* The server revoking this lock is likely to be waiting for
+		 * more of them, cancel those first. */
+		if (rc == LDLM_FL_BL_AST)
+			count += ldlm_bl_cancel_pending(ns, exp, &cancels,
+							avail - count);
 		lru_flags = ns_connect_lru_resize(ns) ?
 			LDLM_LRU_FLAG_LRUR : LDLM_LRU_FLAG_AGED;
-		count += ldlm_cancel_lru_local(ns, &cancels, 0, avail - 1,
-					       LCF_BL_AST, lru_flags);
+		if (avail > count)
+			count += ldlm_cancel_lru_local(ns, &cancels, 0,
+						       avail - count,
+						       LCF_BL_AST, lru_flags);
 	}
 	ldlm_cli_cancel_list(&cancels, count, NULL, cancel_flags);
 	RETURN(0);
@@ -1777,7 +1784,7 @@ static int ldlm_prepare_lru_list(struct ldlm_namespace *ns,
 		enum ldlm_policy_res result;
 		ktime_t last_use = ktime_set(0, 0);
 
-		spin_lock(&ns->ns_lock);
+		ldlm_ns_lru_lock(ns);
 		item = no_wait ? ns->ns_last_pos : &ns->ns_unused_list;
 		for (item = item->next, next = item->next;
 		     item != &ns->ns_unused_list;
@@ -1787,6 +1794,18 @@ static int ldlm_prepare_lru_list(struct ldlm_namespace *ns,
 			/* No locks which got blocking requests. */
 			LASSERT(!ldlm_is_bl_ast(lock));
 
+			/* Used since it was added, move it to the tail as
+			 * ldlm_lock_touch_in_lru() did not. */
+			if (lock->l_lru_touched && !ldlm_is_canceling(lock)) {
+				lock->l_lru_touched = false;
+				if (ns->ns_last_pos == item)
+					ns->ns_last_pos = item->prev;
+				list_move_tail(item, &ns->ns_unused_list);
+				if (next == &ns->ns_unused_list)
+					next = item;
+				continue;
+			}
+
 			if (!ldlm_is_canceling(lock))
 				break;
 
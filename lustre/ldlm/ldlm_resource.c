@@ -215,6 +215,9 @@ static struct lprocfs_vars ldlm_debugfs_list[] = {
 	{ .name =	"lock_granted_count",
 	  .fops =	&ldlm_granted_fops,
 	  .data =	&ldlm_granted_total },
+	{ .name =	"lock_fair_share",
+	  .fops =	&ldlm_rw_uint_fops,
+	  .data =	&ldlm_lock_fair_share },
 #endif
 	{ NULL }
 };
@@ -319,6 +322,19 @@ static ssize_t lock_count_show(struct kobject *kobj, struct attribute *attr,
 }
 LUSTRE_RO_ATTR(lock_count);
 
+static ssize_t lock_bl_ast_count_show(struct kobject *kobj,
+				      struct attribute *attr, char *buf)
+{
+	struct ldlm_namespace *ns = container_of(kobj, struct ldlm_namespace,
+						 ns_kobj);
+	__u64 count;
+
+	count = lprocfs_stats_collector(ns->ns_stats, LDLM_NSS_BL_ASTS,
+					LPROCFS_FIELDS_FLAGS_SUM);
+	return sprintf(buf, "%lld\n", count);
+}
+LUSTRE_RO_ATTR(lock_bl_ast_count);
+
 static ssize_t lock_unused_count_show(struct kobject *kobj,
 				      struct attribute *attr,
 				      char *buf)
@@ -330,6 +346,19 @@ static ssize_t lock_unused_count_show(struct kobject *kobj,
 }
 LUSTRE_RO_ATTR(lock_unused_count);
 
+static ssize_t lru_lock_contended_show(struct kobject *kobj,
+				       struct attribute *attr, char *buf)
+{
+	struct ldlm_namespace *ns = container_of(kobj, struct ldlm_namespace,
+						 ns_kobj);
+	__u64 count;
+
+	count = lprocfs_stats_collector(ns->ns_stats, LDLM_NSS_LRU_CONTENDED,
+					LPROCFS_FIELDS_FLAGS_SUM);
+	return sprintf(buf, "%lld\n", count);
+}
+LUSTRE_RO_ATTR(lru_lock_contended);
+
 static ssize_t lru_size_show(struct kobject *kobj, struct attribute *attr,
 			     char *buf)
 {
@@ -664,13 +693,57 @@ static ssize_t max_parallel_ast_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(max_parallel_ast);
 
+static ssize_t lock_expand_pattern_show(struct kobject *kobj,
+					struct attribute *attr, char *buf)
+{
+	struct ldlm_namespace *ns = container_of(kobj, struct ldlm_namespace,
+						 ns_kobj);
+
+	return sprintf(buf, "%u\n", ns->ns_expand_pattern);
+}
+
+static ssize_t lock_expand_pattern_store(struct kobject *kobj,
+					 struct attribute *attr,
+					 const char *buffer, size_t count)
+{
+	struct ldlm_namespace *ns = container_of(kobj, struct ldlm_namespace,
+						 ns_kobj);
+	bool val;
+	int err;
+
+	err = kstrtobool(buffer, &val);
+	if (err)
+		return err;
+
+	ns->ns_expand_pattern = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(lock_expand_pattern);
+
+static ssize_t lock_expand_limited_count_show(struct kobject *kobj,
+					      struct attribute *attr,
+					      char *buf)
+{
+	struct ldlm_namespace *ns = container_of(kobj, struct ldlm_namespace,
+						 ns_kobj);
+	__u64 count;
+
+	count = lprocfs_stats_collector(ns->ns_stats, LDLM_NSS_EXPAND_LIMITED,
+					LPROCFS_FIELDS_FLAGS_SUM);
+	return sprintf(buf, "%lld\n", count);
+}
+LUSTRE_RO_ATTR(lock_expand_limited_count);
+
 #endif /* HAVE_SERVER_SUPPORT */
 
 /* These are for namespaces in /sys/fs/lustre/ldlm/namespaces/ */
 static struct attribute *ldlm_ns_attrs[] = {
 	&lustre_attr_resource_count.attr,
 	&lustre_attr_lock_count.attr,
+	&lustre_attr_lock_bl_ast_count.attr,
 	&lustre_attr_lock_unused_count.attr,
+	&lustre_attr_lru_lock_contended.attr,
 	&lustre_attr_lru_size.attr,
 	&lustre_attr_lru_max_age.attr,
 	&lustre_attr_early_lock_cancel.attr,
@@ -682,6 +755,8 @@ static struct attribute *ldlm_ns_attrs[] = {
 	&lustre_attr_contention_seconds.attr,
 	&lustre_attr_contended_locks.attr,
 	&lustre_attr_max_parallel_ast.attr,
+	&lustre_attr_lock_expand_pattern.attr,
+	&lustre_attr_lock_expand_limited_count.attr,
 #endif
 	NULL,
 };
@@ -734,6 +809,12 @@ int ldlm_namespace_sysfs_register(struct ldlm_namespace *ns)
 
 	lprocfs_counter_init(ns->ns_stats, LDLM_NSS_LOCKS,
 			     LPROCFS_CNTR_AVGMINMAX, "locks", "locks");
+	lprocfs_counter_init(ns->ns_stats, LDLM_NSS_BL_ASTS,
+			     LPROCFS_CNTR_AVGMINMAX, "bl_asts", "asts");
+	lprocfs_counter_init(ns->ns_stats, LDLM_NSS_EXPAND_LIMITED,
+			     LPROCFS_CNTR_AVGMINMAX, "expand_limited", "locks");
+	lprocfs_counter_init(ns->ns_stats, LDLM_NSS_LRU_CONTENDED,
+			     LPROCFS_CNTR_AVGMINMAX, "lru_contended", "locks");
 
 	return err;
 }
@@ -985,6 +1066,7 @@ struct ldlm_namespace *ldlm_namespace_new(struct obd_device *obd, char *name,
 	ns->ns_max_nolock_size    = NS_DEFAULT_MAX_NOLOCK_BYTES;
 	ns->ns_contention_time    = NS_DEFAULT_CONTENTION_SECONDS;
 	ns->ns_contended_locks    = NS_DEFAULT_CONTENDED_LOCKS;
+	ns->ns_expand_pattern     = 1;
 
         ns->ns_max_parallel_ast   = LDLM_DEFAULT_PARALLEL_AST_LIMIT;
         ns->ns_nr_unused          = 0;
@@ -1477,6 +1559,8 @@ static void ldlm_resource_free(struct ldlm_resource *res)
 		if (res->lr_itree != NULL)
 			OBD_SLAB_FREE(res->lr_itree, ldlm_interval_tree_slab,
 				      sizeof(*res->lr_itree) * LCK_MODE_NUM);
+		if (res->lr_ext_hist != NULL)
+			OBD_FREE_PTR(res->lr_ext_hist);
 	} else if (res->lr_type == LDLM_IBITS) {
 		if (res->lr_ibits_queues != NULL)
 			OBD_FREE_PTR(res->lr_ibits_queues);
@@ -201,6 +201,75 @@ static u16 ll_dirent_type_get(struct lu_dirent *ent)
 	return type;
 }
 
+/**
+ * Instantiate the dentry of a dirent whose inode is still cached with its
+ * LOOKUP and UPDATE ibits locks, so that a following stat() of the name
+ * needs neither lookup nor statahead RPC. Caller holds the dir i_mutex, so
+ * this can't race with a lookup of the same name.
+ */
+static void ll_dir_prefill_dentry(struct dentry *parent, const char *name,
+				  int namelen, struct lu_fid *fid)
+{
+	struct ll_sb_info *sbi = ll_i2sbi(parent->d_inode);
+	struct lookup_intent it = { .it_op = IT_GETATTR,
+				    .it_lock_handle = 0 };
+	struct qstr qstr = QSTR_INIT(name, namelen);
+	struct dentry *dentry;
+	struct dentry *alias;
+	struct inode *inode;
+	__u64 bits = 0;
+
+	if (!fid_is_sane(fid))
+		return;
+
+	qstr.hash = ll_full_name_hash(parent, name, namelen);
+	dentry = d_lookup(parent, &qstr);
+	if (dentry != NULL) {
+		dput(dentry);
+		return;
+	}
+
+	inode = ilookup5(parent->d_sb,
+			 cl_fid_build_ino(fid, ll_need_32bit_api(sbi)),
+			 ll_test_inode_by_fid, fid);
+	if (inode == NULL)
+		return;
+
+	/* don't move directory aliases around from readdir */
+	if (S_ISDIR(inode->i_mode) ||
+	    md_revalidate_lock(sbi->ll_md_exp, &it, fid, &bits) != 1)
+		goto out_inode;
+
+	if (!(bits & MDS_INODELOCK_LOOKUP))
+		goto out_intent;
+
+	dentry = d_alloc(parent, &qstr);
+	if (dentry == NULL)
+		goto out_intent;
+
+	alias = ll_splice_alias(inode, dentry);
+	if (IS_ERR(alias)) {
+		dput(dentry);
+		goto out_intent;
+	}
+	inode = NULL;
+
+	d_lustre_revalidate(alias);
+	atomic_inc(&sbi->ll_dir_prefilled);
+	CDEBUG(D_DENTRY, "%s: prefill dentry %.*s "DFID" from readdir\n",
+	       ll_get_fsname(parent->d_sb, NULL, 0), namelen, name,
+	       PFID(fid));
+
+	if (alias != dentry)
+		dput(alias);
+	dput(dentry);
+out_intent:
+	ll_intent_release(&it);
+out_inode:
+	if (inode != NULL)
+		iput(inode);
+}
+
 #ifdef HAVE_DIR_CONTEXT
 int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 		struct dir_context *ctx)
@@ -216,12 +285,17 @@ int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 	bool                  is_hash64 = sbi->ll_flags & LL_SBI_64BIT_HASH;
 	struct page          *page;
 	struct ll_dir_chain   chain;
+	struct dentry        *parent = NULL;
 	bool                  done = false;
 	int                   rc = 0;
 	ENTRY;
 
 	ll_dir_chain_init(&chain);
 
+	/* the dir may be scanned by stat() of its entries, see statahead */
+	if (sbi->ll_sa_max != 0)
+		parent = d_find_alias(inode);
+
 	page = ll_get_dir_page(inode, op_data, pos, &chain);
 
 	while (rc == 0 && !done) {
@@ -271,6 +345,9 @@ int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 			done = filldir(cookie, ent->lde_name, namelen, lhash,
 				       ino, type);
 #endif
+			if (!done && parent != NULL)
+				ll_dir_prefill_dentry(parent, ent->lde_name,
+						      namelen, &fid);
 		}
 
 		if (done) {
@@ -306,6 +383,8 @@ int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 	*ppos = pos;
 #endif
 	ll_dir_chain_fini(&chain);
+	if (parent != NULL)
+		dput(parent);
 	RETURN(rc);
 }
 
@@ -547,6 +547,12 @@ retry:
 	}
 	op_data->op_data = lmm;
 	op_data->op_data_size = lmmsize;
+	/* The size is known from a previous getattr or statahead, if none of
+	 * the data is cached yet, ask for room to get it all with the open.
+	 */
+	if (S_ISREG(de->d_inode->i_mode) &&
+	    de->d_inode->i_mapping->nrpages == 0)
+		op_data->op_dom_open_size = i_size_read(de->d_inode);
 
 	rc = md_intent_lock(sbi->ll_md_exp, op_data, itp, &req,
 			    &ll_md_blocking_ast, 0);
@@ -630,7 +636,7 @@ static int ll_local_open(struct file *file, struct lookup_intent *it,
 	}
 
 	LUSTRE_FPRIVATE(file) = fd;
-	ll_readahead_init(inode, &fd->fd_ras);
+	ll_readahead_init(inode, fd);
 	fd->fd_omode = it->it_flags & (FMODE_READ | FMODE_WRITE | FMODE_EXEC);
 
 	/* ll_cl_context initialize */
@@ -1346,7 +1352,7 @@ static bool file_is_noatime(const struct file *file)
 	return false;
 }
 
-static void ll_io_init(struct cl_io *io, struct file *file, enum cl_io_type iot)
+void ll_io_init(struct cl_io *io, struct file *file, enum cl_io_type iot)
 {
 	struct inode *inode = file_inode(file);
 	struct ll_file_data *fd  = LUSTRE_FPRIVATE(file);
@@ -1369,6 +1375,8 @@ static void ll_io_init(struct cl_io *io, struct file *file, enum cl_io_type iot)
 		io->ci_lockreq = CILR_MANDATORY;
 	}
 	io->ci_noatime = file_is_noatime(file);
+	/* the stripes of a direct IO write are issued in parallel */
+	io->ci_parallel_dio = iot == CIT_WRITE && file->f_flags & O_DIRECT;
 
 	/* FLR: only use non-delay I/O for read as there is only one
 	 * avaliable mirror for write. */
@@ -344,6 +344,9 @@ static inline struct ll_inode_info *ll_i2info(struct inode *inode)
 /* default to read-ahead full files smaller than 2MB on the second read */
 #define SBI_DEFAULT_READAHEAD_WHOLE_MAX		MiB_TO_PAGES(2UL)
 
+/* max number of async read-ahead works in flight per filesystem */
+#define LL_RA_ASYNC_ACTIVE_MAX			256
+
 enum ra_stat {
         RA_STAT_HIT = 0,
         RA_STAT_MISS,
@@ -358,6 +361,8 @@ enum ra_stat {
         RA_STAT_MAX_IN_FLIGHT,
         RA_STAT_WRONG_GRAB_PAGE,
 	RA_STAT_FAILED_REACH_END,
+	RA_STAT_NEW_STREAM,
+	RA_STAT_ASYNC,
 	_NR_RA_STAT,
 };
 
@@ -366,6 +371,11 @@ struct ll_ra_info {
 	unsigned long	ra_max_pages;
 	unsigned long	ra_max_pages_per_file;
 	unsigned long	ra_max_read_ahead_whole_pages;
+	/* work queue issuing read-ahead asynchronously to the reader */
+	struct workqueue_struct *ra_async_wq;
+	/* max number of async read-ahead works in flight, 0 to disable */
+	unsigned int	ra_async_max_active;
+	atomic_t	ra_async_inflight;
 };
 
 /* ra_io_arg will be filled in the beginning of ll_readahead with
@@ -558,6 +568,10 @@ struct ll_sb_info {
 	atomic_t		  ll_sa_running; /* running statahead thread
 						  * count */
 	atomic_t		  ll_agl_total;  /* AGL thread started count */
+	atomic_t		  ll_sa_cached;  /* statahead entries found
+						  * cached by FID, no RPC */
+	atomic_t		  ll_dir_prefilled; /* dentries instantiated
+						     * from readdir */
 
 	dev_t			  ll_sdev_orig; /* save s_dev before assign for
 						 * clustred nfs */
@@ -658,12 +672,40 @@ struct ll_readahead_state {
          * stride read-ahead will be enable
          */
         unsigned long   ras_consecutive_stride_requests;
+	/*
+	 * ll_file_data::fd_ras_seq of the last read request assigned to this
+	 * stream, used to find the least recently used stream to recycle.
+	 */
+	unsigned long	ras_last_used;
+	/* read-ahead hits and misses of this stream, for debugging */
+	unsigned long	ras_hits;
+	unsigned long	ras_misses;
+	/* an async read-ahead work is queued for this stream */
+	bool		ras_async_pending;
+	/*
+	 * incremented each time the stream is recycled by ras_stream_new(),
+	 * so that an async read-ahead work queued before doesn't update the
+	 * window of the new stream
+	 */
+	unsigned int	ras_gen;
 };
 
+/*
+ * Number of independent read-ahead streams tracked for an open file, so that
+ * interleaved reads of different regions through the same file descriptor
+ * do not keep resetting each other's read-ahead window.
+ */
+#define LL_RA_STREAMS	4
+
 extern struct kmem_cache *ll_file_data_slab;
 struct lustre_handle;
 struct ll_file_data {
-	struct ll_readahead_state fd_ras;
+	struct ll_readahead_state fd_ras[LL_RA_STREAMS];
+	/* protect fd_ras_last, fd_ras_seq and assignment of fd_ras streams */
+	spinlock_t fd_ras_lock;
+	/* stream used by the most recent read request */
+	struct ll_readahead_state *fd_ras_last;
+	unsigned long fd_ras_seq;
 	struct ll_grouplock fd_grouplock;
 	__u64 lfd_pos;
 	__u32 fd_flags;
@@ -732,7 +774,7 @@ static inline bool ll_sbi_has_tiny_write(struct ll_sb_info *sbi)
 	return !!(sbi->ll_flags & LL_SBI_TINY_WRITE);
 }
 
-void ll_ras_enter(struct file *f);
+struct ll_readahead_state *ll_ras_enter(struct file *f, pgoff_t index);
 
 /* llite/lcommon_misc.c */
 int cl_ocd_update(struct obd_device *host, struct obd_device *watched,
@@ -834,7 +876,9 @@ int ll_writepages(struct address_space *, struct writeback_control *wbc);
 int ll_readpage(struct file *file, struct page *page);
 int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 			   struct cl_page *page, struct file *file);
-void ll_readahead_init(struct inode *inode, struct ll_readahead_state *ras);
+void ll_readahead_init(struct inode *inode, struct ll_file_data *fd);
+int ll_readahead_async_init(struct ll_sb_info *sbi);
+void ll_readahead_async_fini(struct ll_sb_info *sbi);
 int vvp_io_write_commit(const struct lu_env *env, struct cl_io *io);
 
 enum lcc_type;
@@ -858,6 +902,7 @@ extern enum ldlm_mode ll_take_md_lock(struct inode *inode, __u64 bits,
 
 int ll_file_open(struct inode *inode, struct file *file);
 int ll_file_release(struct inode *inode, struct file *file);
+void ll_io_init(struct cl_io *io, struct file *file, enum cl_io_type iot);
 int ll_release_openhandle(struct dentry *, struct lookup_intent *);
 int ll_md_real_close(struct inode *inode, fmode_t fmode);
 extern void ll_rw_stats_tally(struct ll_sb_info *sbi, pid_t pid,
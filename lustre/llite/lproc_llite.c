@@ -744,6 +744,43 @@ static ssize_t statahead_running_max_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(statahead_running_max);
 
+static ssize_t max_read_ahead_async_active_show(struct kobject *kobj,
+						struct attribute *attr,
+						char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return snprintf(buf, PAGE_SIZE, "%u\n",
+			sbi->ll_ra_info.ra_async_max_active);
+}
+
+static ssize_t max_read_ahead_async_active_store(struct kobject *kobj,
+						 struct attribute *attr,
+						 const char *buffer,
+						 size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 10, &val);
+	if (rc)
+		return rc;
+
+	if (val <= LL_RA_ASYNC_ACTIVE_MAX) {
+		sbi->ll_ra_info.ra_async_max_active = val;
+		return count;
+	}
+
+	CERROR("Bad max_read_ahead_async_active value %u. Valid values "
+	       "are in the range [0, %d]\n", val, LL_RA_ASYNC_ACTIVE_MAX);
+
+	return -ERANGE;
+}
+LUSTRE_RW_ATTR(max_read_ahead_async_active);
+
 static ssize_t statahead_max_show(struct kobject *kobj,
 				  struct attribute *attr,
 				  char *buf)
@@ -818,10 +855,14 @@ static int ll_statahead_stats_seq_show(struct seq_file *m, void *v)
 
 	seq_printf(m, "statahead total: %u\n"
 		      "statahead wrong: %u\n"
-		      "agl total: %u\n",
+		      "agl total: %u\n"
+		      "statahead cached: %u\n"
+		      "readdir prefilled: %u\n",
 		   atomic_read(&sbi->ll_sa_total),
 		   atomic_read(&sbi->ll_sa_wrong),
-		   atomic_read(&sbi->ll_agl_total));
+		   atomic_read(&sbi->ll_agl_total),
+		   atomic_read(&sbi->ll_sa_cached),
+		   atomic_read(&sbi->ll_dir_prefilled));
 	return 0;
 }
 
@@ -1276,6 +1317,7 @@ static struct attribute *llite_attrs[] = {
 	&lustre_attr_default_easize.attr,
 	&lustre_attr_xattr_cache.attr,
 	&lustre_attr_fast_read.attr,
+	&lustre_attr_max_read_ahead_async_active.attr,
 	&lustre_attr_tiny_write.attr,
 	NULL,
 };
@@ -1375,7 +1417,9 @@ static const char *ra_stat_string[] = {
 	[RA_STAT_EOF] = "read-ahead to EOF",
 	[RA_STAT_MAX_IN_FLIGHT] = "hit max r-a issue",
 	[RA_STAT_WRONG_GRAB_PAGE] = "wrong page from grab_cache_page",
-	[RA_STAT_FAILED_REACH_END] = "failed to reach end"
+	[RA_STAT_FAILED_REACH_END] = "failed to reach end",
+	[RA_STAT_NEW_STREAM] = "new read-ahead stream",
+	[RA_STAT_ASYNC] = "async readahead"
 };
 
 int ll_debugfs_register_super(struct super_block *sb, const char *name)
@@ -130,14 +130,15 @@ void ll_ra_stats_inc(struct inode *inode, enum ra_stat which)
 #define RAS_CDEBUG(ras) \
 	CDEBUG(D_READA,                                                      \
 	       "lrp %lu cr %lu cp %lu ws %lu wl %lu nra %lu rpc %lu "        \
-	       "r %lu ri %lu csr %lu sf %lu sp %lu sl %lu\n",                \
+	       "r %lu ri %lu csr %lu sf %lu sp %lu sl %lu h %lu m %lu\n",    \
 	       ras->ras_last_readpage, ras->ras_consecutive_requests,        \
 	       ras->ras_consecutive_pages, ras->ras_window_start,            \
 	       ras->ras_window_len, ras->ras_next_readahead,                 \
 	       ras->ras_rpc_size,                                            \
 	       ras->ras_requests, ras->ras_request_index,                    \
 	       ras->ras_consecutive_stride_requests, ras->ras_stride_offset, \
-	       ras->ras_stride_pages, ras->ras_stride_length)
+	       ras->ras_stride_pages, ras->ras_stride_length,                \
+	       ras->ras_hits, ras->ras_misses)
 
 static int index_in_window(unsigned long index, unsigned long point,
                            unsigned long before, unsigned long after)
@@ -152,18 +153,6 @@ static int index_in_window(unsigned long index, unsigned long point,
         return start <= index && index <= end;
 }
 
-void ll_ras_enter(struct file *f)
-{
-	struct ll_file_data *fd = LUSTRE_FPRIVATE(f);
-	struct ll_readahead_state *ras = &fd->fd_ras;
-
-	spin_lock(&ras->ras_lock);
-	ras->ras_requests++;
-	ras->ras_request_index = 0;
-	ras->ras_consecutive_requests++;
-	spin_unlock(&ras->ras_lock);
-}
-
 /**
  * Initiates read-ahead of a page with given index.
  *
@@ -425,9 +414,200 @@ ll_read_ahead_pages(const struct lu_env *env, struct cl_io *io,
 	return count;
 }
 
+/**
+ * Read-ahead work issued asynchronously to the reader.
+ */
+struct ll_readahead_work {
+	/** file to read ahead, a reference is held until the work is done */
+	struct file			*lrw_file;
+	/** read-ahead stream of the file the work is issued for */
+	struct ll_readahead_state	*lrw_ras;
+	/** ll_readahead_state::ras_gen of the stream when it was queued */
+	unsigned int			 lrw_ras_gen;
+	/** read-ahead window computed by the reader */
+	struct ra_io_arg		 lrw_ria;
+	struct work_struct		 lrw_readahead_work;
+};
+
+static void ll_readahead_handle_work(struct work_struct *wq)
+{
+	struct ll_readahead_work *work;
+	struct ll_readahead_state *ras;
+	struct ra_io_arg *ria;
+	struct ll_sb_info *sbi;
+	struct cl_2queue *queue;
+	struct inode *inode;
+	struct file *file;
+	struct lu_env *env;
+	struct cl_io *io;
+	pgoff_t ra_end = 0;
+	__u16 refcheck;
+	int rc;
+	ENTRY;
+
+	work = container_of(wq, struct ll_readahead_work, lrw_readahead_work);
+	file = work->lrw_file;
+	ras = work->lrw_ras;
+	inode = file_inode(file);
+	sbi = ll_i2sbi(inode);
+
+	env = cl_env_get(&refcheck);
+	if (IS_ERR(env))
+		GOTO(out_free_work, rc = PTR_ERR(env));
+
+	ria = &ll_env_info(env)->lti_ria;
+	*ria = work->lrw_ria;
+
+	io = vvp_env_thread_io(env);
+	ll_io_init(io, file, CIT_READ);
+	/* read-ahead is best effort, only use the locks the client already
+	 * caches, the window is skipped if the reader doesn't hold one */
+	io->ci_lock_match = 1;
+
+	rc = cl_io_rw_init(env, io, CIT_READ, cl_offset(io->ci_obj, ria->ria_start),
+			   cl_offset(io->ci_obj,
+				     ria->ria_end - ria->ria_start + 1));
+	if (rc != 0)
+		GOTO(out_io_fini, rc);
+
+	vvp_env_io(env)->vui_fd = LUSTRE_FPRIVATE(file);
+	vvp_env_io(env)->vui_io_subtype = IO_NORMAL;
+
+	rc = cl_io_iter_init(env, io);
+	if (rc == 0) {
+		rc = cl_io_lock(env, io);
+		if (rc == 0) {
+			ria->ria_reserved = ll_ra_count_get(sbi, ria,
+							    ria_page_count(ria),
+							    0);
+			queue = &io->ci_queue;
+			cl_2queue_init(queue);
+
+			rc = ll_read_ahead_pages(env, io, &queue->c2_qin, ras,
+						 ria, &ra_end);
+			if (ria->ria_reserved != 0)
+				ll_ra_count_put(sbi, ria->ria_reserved);
+
+			if (queue->c2_qin.pl_nr > 0)
+				rc = cl_io_submit_rw(env, io, CRT_READ, queue);
+
+			cl_page_list_discard(env, io, &queue->c2_qin);
+			/* Unlock unsent read pages in case of error. */
+			cl_page_list_disown(env, io, &queue->c2_qin);
+			cl_2queue_fini(env, queue);
+			cl_io_unlock(env, io);
+		}
+	}
+	cl_io_iter_fini(env, io);
+	EXIT;
+out_io_fini:
+	cl_io_fini(env, io);
+	cl_env_put(env, &refcheck);
+out_free_work:
+	CDEBUG(D_READA, DFID": async read-ahead [%lu, %lu] done at %lu: rc = %d\n",
+	       PFID(ll_inode2fid(inode)), work->lrw_ria.ria_start,
+	       work->lrw_ria.ria_end, ra_end, rc);
+
+	spin_lock(&ras->ras_lock);
+	/* update the ras so that the next read-ahead tries from where
+	 * we left off, unless the stream has been recycled meanwhile */
+	if (ra_end > 0 && ras->ras_gen == work->lrw_ras_gen)
+		ras->ras_next_readahead = ra_end + 1;
+	ras->ras_async_pending = false;
+	spin_unlock(&ras->ras_lock);
+
+	ll_ra_stats_inc_sbi(sbi, RA_STAT_ASYNC);
+	atomic_dec(&sbi->ll_ra_info.ra_async_inflight);
+	fput(file);
+	OBD_FREE_PTR(work);
+}
+
+/**
+ * Queue the read-ahead window \a ria of stream \a ras to be issued by
+ * the async read-ahead work queue, so that the reader doesn't wait for the
+ * read-ahead pages to be prepared and sent.
+ *
+ * \retval 0		the window is being read ahead asynchronously
+ * \retval negative	read-ahead has to be done by the caller
+ */
+static int ll_readahead_async(struct file *file, struct ll_readahead_state *ras,
+			      struct ra_io_arg *ria)
+{
+	struct ll_ra_info *ra = &ll_i2sbi(file_inode(file))->ll_ra_info;
+	struct ll_readahead_work *work;
+	unsigned int gen;
+	int rc = 0;
+
+	if (ra->ra_async_wq == NULL || ra->ra_async_max_active == 0)
+		return -EOPNOTSUPP;
+
+	spin_lock(&ras->ras_lock);
+	if (ras->ras_async_pending) {
+		/* the work in flight covers an earlier window, read this
+		 * one ahead synchronously rather than not at all */
+		spin_unlock(&ras->ras_lock);
+		return -EBUSY;
+	}
+	ras->ras_async_pending = true;
+	gen = ras->ras_gen;
+	spin_unlock(&ras->ras_lock);
+
+	if (atomic_inc_return(&ra->ra_async_inflight) >
+	    ra->ra_async_max_active)
+		GOTO(out_dec, rc = -EBUSY);
+
+	OBD_ALLOC_PTR(work);
+	if (work == NULL)
+		GOTO(out_dec, rc = -ENOMEM);
+
+	get_file(file);
+	work->lrw_file = file;
+	work->lrw_ras = ras;
+	work->lrw_ras_gen = gen;
+	work->lrw_ria = *ria;
+	INIT_WORK(&work->lrw_readahead_work, ll_readahead_handle_work);
+	queue_work(ra->ra_async_wq, &work->lrw_readahead_work);
+
+	return 0;
+
+out_dec:
+	atomic_dec(&ra->ra_async_inflight);
+	spin_lock(&ras->ras_lock);
+	ras->ras_async_pending = false;
+	spin_unlock(&ras->ras_lock);
+
+	return rc;
+}
+
+int ll_readahead_async_init(struct ll_sb_info *sbi)
+{
+	struct ll_ra_info *ra = &sbi->ll_ra_info;
+
+	ra->ra_async_wq = alloc_workqueue("ll_readahead_wq", 0, 0);
+	if (ra->ra_async_wq == NULL)
+		return -ENOMEM;
+
+	ra->ra_async_max_active = max_t(unsigned int,
+					num_online_cpus() / 2, 1);
+	atomic_set(&ra->ra_async_inflight, 0);
+
+	return 0;
+}
+
+void ll_readahead_async_fini(struct ll_sb_info *sbi)
+{
+	struct ll_ra_info *ra = &sbi->ll_ra_info;
+
+	if (ra->ra_async_wq != NULL) {
+		destroy_workqueue(ra->ra_async_wq);
+		ra->ra_async_wq = NULL;
+	}
+}
+
 static int ll_readahead(const struct lu_env *env, struct cl_io *io,
 			struct cl_page_list *queue,
-			struct ll_readahead_state *ras, bool hit)
+			struct ll_readahead_state *ras, bool hit,
+			struct file *file)
 {
 	struct vvp_io *vio = vvp_env_io(env);
 	struct ll_thread_info *lti = ll_env_info(env);
@@ -518,6 +698,11 @@ static int ll_readahead(const struct lu_env *env, struct cl_io *io,
 	       vio->vui_ra_valid ? vio->vui_ra_count : 0,
 	       hit);
 
+	/* the reader doesn't wait for any page of the window on a read-ahead
+	 * hit, so prepare and send the window asynchronously */
+	if (hit && ll_readahead_async(file, ras, ria) == 0)
+		RETURN(0);
+
 	/* at least to extend the readahead window to cover current read */
 	if (!hit && vio->vui_ra_valid &&
 	    vio->vui_ra_start + vio->vui_ra_count > ria->ria_start) {
@@ -594,12 +779,30 @@ static void ras_stride_reset(struct ll_readahead_state *ras)
         RAS_CDEBUG(ras);
 }
 
-void ll_readahead_init(struct inode *inode, struct ll_readahead_state *ras)
+static void ras_init(struct inode *inode, struct ll_readahead_state *ras)
 {
-	spin_lock_init(&ras->ras_lock);
 	ras->ras_rpc_size = PTLRPC_MAX_BRW_PAGES;
 	ras_reset(inode, ras, 0);
 	ras->ras_requests = 0;
+	ras->ras_last_used = 0;
+	ras->ras_hits = 0;
+	ras->ras_misses = 0;
+	ras_stride_reset(ras);
+}
+
+void ll_readahead_init(struct inode *inode, struct ll_file_data *fd)
+{
+	int i;
+
+	spin_lock_init(&fd->fd_ras_lock);
+	for (i = 0; i < LL_RA_STREAMS; i++) {
+		spin_lock_init(&fd->fd_ras[i].ras_lock);
+		ras_init(inode, &fd->fd_ras[i]);
+		fd->fd_ras[i].ras_async_pending = false;
+		fd->fd_ras[i].ras_gen = 0;
+	}
+	fd->fd_ras_last = &fd->fd_ras[0];
+	fd->fd_ras_seq = 0;
 }
 
 /*
@@ -626,6 +829,141 @@ static int index_in_stride_window(struct ll_readahead_state *ras,
 		ras->ras_consecutive_pages == ras->ras_stride_pages;
 }
 
+/*
+ * Check whether the page at \a index belongs to the access stream tracked by
+ * \a ras: it is close to the last page read, inside the read-ahead window,
+ * or at the next step of the detected stride pattern.
+ */
+static bool ras_stream_match(struct ll_readahead_state *ras,
+			     unsigned long index)
+{
+	if (index_in_window(index, ras->ras_last_readpage, 8, 8))
+		return true;
+
+	if (ras->ras_window_len > 0 &&
+	    index_in_window(index, ras->ras_window_start, 0,
+			    ras->ras_window_len - 1))
+		return true;
+
+	return ras->ras_consecutive_stride_requests > 0 &&
+	       index_in_stride_window(ras, index);
+}
+
+/* called with fd_ras_lock held */
+static struct ll_readahead_state *ras_stream_find(struct ll_file_data *fd,
+						  unsigned long index)
+{
+	int i;
+
+	/* the stream of the last request is the most likely one */
+	if (ras_stream_match(fd->fd_ras_last, index))
+		return fd->fd_ras_last;
+
+	for (i = 0; i < LL_RA_STREAMS; i++) {
+		if (&fd->fd_ras[i] != fd->fd_ras_last &&
+		    ras_stream_match(&fd->fd_ras[i], index))
+			return &fd->fd_ras[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * Start a new read-ahead stream at \a index by recycling the least recently
+ * used stream of the file.
+ *
+ * The access history of the stream used by the last request is copied into
+ * the new stream, so that ras_update() still sees this access as a seek from
+ * it and can detect the stride pattern, while the old stream keeps its
+ * read-ahead window for the reader which may continue there.
+ *
+ * Called with fd_ras_lock held.
+ */
+static struct ll_readahead_state *ras_stream_new(struct inode *inode,
+						 struct ll_file_data *fd,
+						 unsigned long index)
+{
+	struct ll_readahead_state *last = fd->fd_ras_last;
+	struct ll_readahead_state *ras = NULL;
+	int i;
+
+	for (i = 0; i < LL_RA_STREAMS; i++) {
+		if (&fd->fd_ras[i] == last)
+			continue;
+		if (ras == NULL ||
+		    fd->fd_ras[i].ras_last_used < ras->ras_last_used)
+			ras = &fd->fd_ras[i];
+	}
+
+	/* NB: fields of last stream are read without its lock, it's racy
+	 * but doesn't matter, the detector recovers on the next request */
+	spin_lock(&ras->ras_lock);
+	/* a pending async read-ahead of the old stream is left running, its
+	 * result is dropped, see ll_readahead_handle_work() */
+	ras->ras_gen++;
+	ras_init(inode, ras);
+	ras->ras_rpc_size = last->ras_rpc_size;
+	ras->ras_requests = last->ras_requests;
+	ras->ras_last_readpage = last->ras_last_readpage;
+	ras->ras_consecutive_pages = last->ras_consecutive_pages;
+	ras->ras_consecutive_stride_requests =
+		last->ras_consecutive_stride_requests;
+	ras->ras_stride_offset = last->ras_stride_offset;
+	ras->ras_stride_pages = last->ras_stride_pages;
+	ras->ras_stride_length = last->ras_stride_length;
+	spin_unlock(&ras->ras_lock);
+
+	ll_ra_stats_inc(inode, RA_STAT_NEW_STREAM);
+	CDEBUG(D_READA, DFID": new read-ahead stream %d at %lu\n",
+	       PFID(ll_inode2fid(inode)), (int)(ras - fd->fd_ras), index);
+
+	return ras;
+}
+
+/**
+ * Called once per read request, find the read-ahead stream this request
+ * continues, or start a new one.
+ */
+struct ll_readahead_state *ll_ras_enter(struct file *f, pgoff_t index)
+{
+	struct ll_file_data *fd = LUSTRE_FPRIVATE(f);
+	struct ll_readahead_state *ras;
+
+	spin_lock(&fd->fd_ras_lock);
+	ras = ras_stream_find(fd, index);
+	if (ras == NULL)
+		ras = ras_stream_new(file_inode(f), fd, index);
+	ras->ras_last_used = ++fd->fd_ras_seq;
+	fd->fd_ras_last = ras;
+	spin_unlock(&fd->fd_ras_lock);
+
+	spin_lock(&ras->ras_lock);
+	ras->ras_requests++;
+	ras->ras_request_index = 0;
+	ras->ras_consecutive_requests++;
+	spin_unlock(&ras->ras_lock);
+
+	return ras;
+}
+
+/*
+ * Find the read-ahead stream for a page read without a read request, e.g.
+ * through mmap or fast read. No new stream is started for such pages.
+ */
+static struct ll_readahead_state *ll_ras_find(struct ll_file_data *fd,
+					      unsigned long index)
+{
+	struct ll_readahead_state *ras;
+
+	spin_lock(&fd->fd_ras_lock);
+	ras = ras_stream_find(fd, index);
+	if (ras == NULL)
+		ras = fd->fd_ras_last;
+	spin_unlock(&fd->fd_ras_lock);
+
+	return ras;
+}
+
 static void ras_update_stride_detector(struct ll_readahead_state *ras,
                                        unsigned long index)
 {
@@ -735,7 +1073,11 @@ static void ras_update(struct ll_sb_info *sbi, struct inode *inode,
 	if (!hit)
 		CDEBUG(D_READA, DFID " pages at %lu miss.\n",
 		       PFID(ll_inode2fid(inode)), index);
-        ll_ra_stats_inc_sbi(sbi, hit ? RA_STAT_HIT : RA_STAT_MISS);
+	ll_ra_stats_inc_sbi(sbi, hit ? RA_STAT_HIT : RA_STAT_MISS);
+	if (hit)
+		ras->ras_hits++;
+	else
+		ras->ras_misses++;
 
         /* reset the read-ahead window in two cases.  First when the app seeks
          * or reads to some other part of the file.  Secondly if we get a
@@ -1083,7 +1425,8 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 	struct inode              *inode  = vvp_object_inode(page->cp_obj);
 	struct ll_sb_info         *sbi    = ll_i2sbi(inode);
 	struct ll_file_data       *fd     = LUSTRE_FPRIVATE(file);
-	struct ll_readahead_state *ras    = &fd->fd_ras;
+	struct vvp_io		  *vio    = vvp_env_io(env);
+	struct ll_readahead_state *ras;
 	struct cl_2queue          *queue  = &io->ci_queue;
 	struct cl_sync_io	  *anchor = NULL;
 	struct vvp_page           *vpg;
@@ -1094,10 +1437,14 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 	vpg = cl2vvp_page(cl_object_page_slice(page->cp_obj, page));
 	uptodate = vpg->vpg_defer_uptodate;
 
+	if (vio->vui_ra_valid && vio->vui_ras != NULL)
+		ras = vio->vui_ras;
+	else
+		ras = ll_ras_find(fd, vvp_index(vpg));
+
 	if (sbi->ll_ra_info.ra_max_pages_per_file > 0 &&
 	    sbi->ll_ra_info.ra_max_pages > 0 &&
 	    !vpg->vpg_ra_updated) {
-		struct vvp_io *vio = vvp_env_io(env);
 		enum ras_update_flags flags = 0;
 
 		if (uptodate)
@@ -1125,7 +1472,7 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 		int rc2;
 
 		rc2 = ll_readahead(env, io, &queue->c2_qin, ras,
-				   uptodate);
+				   uptodate, file);
 		CDEBUG(D_READA, DFID "%d pages read ahead at %lu\n",
 		       PFID(ll_inode2fid(inode)), rc2, vvp_index(vpg));
 	}
@@ -1186,7 +1533,7 @@ int ll_readpage(struct file *file, struct page *vmpage)
 	if (io == NULL) { /* fast read */
 		struct inode *inode = file_inode(file);
 		struct ll_file_data *fd = LUSTRE_FPRIVATE(file);
-		struct ll_readahead_state *ras = &fd->fd_ras;
+		struct ll_readahead_state *ras = ll_ras_find(fd, vmpage->index);
 		struct lu_env  *local_env = NULL;
 		unsigned long fast_read_pages =
 			max(RA_REMAIN_WINDOW_MIN, ras->ras_rpc_size);
@@ -775,6 +775,48 @@ static int ll_statahead_interpret(struct ptlrpc_request *req,
 	RETURN(rc);
 }
 
+/**
+ * check whether the inode of an entry not found in dcache is still cached
+ * with its ibits lock, by the FID packed in the dir page, similar to
+ * sa_revalidate().
+ *
+ * \retval	1 inode and lock cached, no RPC needed
+ * \retval	0 entry needs async stat RPC
+ */
+static int sa_lookup_cached(struct inode *dir, struct sa_entry *entry)
+{
+	struct lookup_intent it = { .it_op = IT_GETATTR,
+				    .it_lock_handle = 0 };
+	struct super_block *sb = dir->i_sb;
+	struct inode *inode;
+	unsigned long hash;
+	int rc;
+	ENTRY;
+
+	if (!fid_is_sane(&entry->se_fid))
+		RETURN(0);
+
+	hash = cl_fid_build_ino(&entry->se_fid,
+				ll_need_32bit_api(ll_s2sbi(sb)));
+	inode = ilookup5(sb, hash, ll_test_inode_by_fid, &entry->se_fid);
+	if (inode == NULL)
+		RETURN(0);
+
+	rc = md_revalidate_lock(ll_i2mdexp(dir), &it, ll_inode2fid(inode),
+				NULL);
+	if (rc != 1) {
+		iput(inode);
+		RETURN(0);
+	}
+
+	entry->se_inode = inode;
+	entry->se_handle = it.it_lock_handle;
+	ll_intent_release(&it);
+	atomic_inc(&ll_s2sbi(sb)->ll_sa_cached);
+
+	RETURN(1);
+}
+
 /* async stat for file not found in dcache */
 static int sa_lookup(struct inode *dir, struct sa_entry *entry)
 {
@@ -782,6 +824,10 @@ static int sa_lookup(struct inode *dir, struct sa_entry *entry)
 	int                       rc;
 	ENTRY;
 
+	/* inode may still be cached after its dentry was pruned */
+	if (sa_lookup_cached(dir, entry))
+		RETURN(1);
+
 	minfo = sa_prep_data(dir, NULL, entry);
 	if (IS_ERR(minfo))
 		RETURN(PTR_ERR(minfo));
@@ -859,6 +905,8 @@ static void sa_statahead(struct dentry *parent, const char *name, int len,
 	dentry = d_lookup(parent, &entry->se_qstr);
 	if (!dentry) {
 		rc = sa_lookup(dir, entry);
+		if (rc == 1 && agl_should_run(sai, entry->se_inode))
+			ll_agl_add(sai, entry->se_inode, entry->se_index);
 	} else {
 		rc = sa_revalidate(dir, entry, dentry);
 		if (rc == 1 && agl_should_run(sai, dentry->d_inode))
@@ -124,6 +124,8 @@ struct vvp_io {
 	pgoff_t	vui_ra_count;
 	/* Set when vui_ra_{start,count} have been initialized. */
 	bool		vui_ra_valid;
+	/* read-ahead stream of the file used by this read */
+	struct ll_readahead_state *vui_ras;
 };
 
 extern struct lu_device_type vvp_device_type;
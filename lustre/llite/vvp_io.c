@@ -567,6 +567,8 @@ static int vvp_io_rw_lock(const struct lu_env *env, struct cl_io *io,
 		ast_flags |= CEF_NONBLOCK;
 	if (io->ci_lock_no_expand)
 		ast_flags |= CEF_LOCK_NO_EXPAND;
+	if (io->ci_lock_match)
+		ast_flags |= CEF_LOCK_MATCH;
 
 	result = vvp_mmap_locks(env, vio, io);
 	if (result == 0)
@@ -812,7 +814,7 @@ static int vvp_io_read_start(const struct lu_env *env,
 		vio->vui_ra_valid = true;
 		vio->vui_ra_start = cl_index(obj, pos);
 		vio->vui_ra_count = cl_index(obj, tot + PAGE_SIZE - 1);
-		ll_ras_enter(file);
+		vio->vui_ras = ll_ras_enter(file, vio->vui_ra_start);
 	}
 
 	/* BUG: 5972 */
@@ -1520,6 +1522,7 @@ int vvp_io_init(const struct lu_env *env, struct cl_object *obj,
 	CL_IO_SLICE_CLEAN(vio, vui_cl);
 	cl_io_slice_add(io, &vio->vui_cl, obj, &vvp_io_ops);
 	vio->vui_ra_valid = false;
+	vio->vui_ras = NULL;
 	result = 0;
 	if (io->ci_type == CIT_READ || io->ci_type == CIT_WRITE) {
 		size_t count;
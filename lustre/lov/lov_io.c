@@ -855,7 +855,7 @@ static int lov_io_rw_iter_init(const struct lu_env *env,
 	lse = lov_lse(lio->lis_object, index);
 
 	next = MAX_LFS_FILESIZE;
-	if (lse->lsme_stripe_count > 1) {
+	if (lse->lsme_stripe_count > 1 && !io->ci_parallel_dio) {
 		unsigned long ssize = lse->lsme_stripe_size;
 
 		lov_do_div64(start, ssize);
@@ -226,6 +226,8 @@ LUSTRE_RO_ATTR(conn_uuid);
 
 LUSTRE_RW_ATTR(ping);
 
+LUSTRE_RW_ATTR(short_io_bytes);
+
 static int mdc_cached_mb_seq_show(struct seq_file *m, void *v)
 {
 	struct obd_device *dev = m->private;
@@ -435,6 +437,10 @@ static int mdc_stats_seq_show(struct seq_file *seq, void *v)
 		   stats->os_lockless_reads);
 	seq_printf(seq, "lockless_truncate\t\t%llu\n",
 		   stats->os_lockless_truncates);
+	seq_printf(seq, "short_io_read_rpcs\t\t%llu\n",
+		   stats->os_short_io_reads);
+	seq_printf(seq, "short_io_write_rpcs\t\t%llu\n",
+		   stats->os_short_io_writes);
 	return 0;
 }
 
@@ -481,6 +487,36 @@ static ssize_t mdc_dom_min_repsize_seq_write(struct file *file,
 }
 LPROC_SEQ_FOPS(mdc_dom_min_repsize);
 
+static int mdc_dom_max_repsize_seq_show(struct seq_file *m, void *v)
+{
+	struct obd_device *dev = m->private;
+
+	seq_printf(m, "%u\n", dev->u.cli.cl_dom_max_inline_repsize);
+
+	return 0;
+}
+
+static ssize_t mdc_dom_max_repsize_seq_write(struct file *file,
+					     const char __user *buffer,
+					     size_t count, loff_t *off)
+{
+	struct obd_device *dev;
+	unsigned int val;
+	int rc;
+
+	dev =  ((struct seq_file *)file->private_data)->private;
+	rc = kstrtouint_from_user(buffer, count, 0, &val);
+	if (rc)
+		return rc;
+
+	if (val > MDC_DOM_MAX_OPEN_REPSIZE)
+		return -ERANGE;
+
+	dev->u.cli.cl_dom_max_inline_repsize = val;
+	return count;
+}
+LPROC_SEQ_FOPS(mdc_dom_max_repsize);
+
 LPROC_SEQ_FOPS_RO_TYPE(mdc, connect_flags);
 LPROC_SEQ_FOPS_RO_TYPE(mdc, server_uuid);
 LPROC_SEQ_FOPS_RO_TYPE(mdc, timeouts);
@@ -516,6 +552,8 @@ struct lprocfs_vars lprocfs_mdc_obd_vars[] = {
 	  .fops	=	&mdc_stats_fops			},
 	{ .name	=	"mdc_dom_min_repsize",
 	  .fops	=	&mdc_dom_min_repsize_fops	},
+	{ .name	=	"mdc_dom_max_repsize",
+	  .fops	=	&mdc_dom_max_repsize_fops	},
 	{ NULL }
 };
 
@@ -527,6 +565,7 @@ static struct attribute *mdc_attrs[] = {
 	&lustre_attr_mds_conn_uuid.attr,
 	&lustre_attr_conn_uuid.attr,
 	&lustre_attr_ping.attr,
+	&lustre_attr_short_io_bytes.attr,
 	NULL,
 };
 
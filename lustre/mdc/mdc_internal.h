@@ -177,5 +177,8 @@ int mdc_fill_lvb(struct ptlrpc_request *req, struct ost_lvb *lvb);
 /* the minimum inline repsize should be PAGE_SIZE at least */
 #define MDC_DOM_DEF_INLINE_REPSIZE max(8192UL, PAGE_SIZE)
 #define MDC_DOM_MAX_INLINE_REPSIZE XATTR_SIZE_MAX
+/* upper limit for the reply buffer sized to fetch a whole DoM file on open,
+ * the reply must stay well below the LNet message size */
+#define MDC_DOM_MAX_OPEN_REPSIZE (512 * 1024)
 
 #endif
@@ -257,6 +257,7 @@ mdc_intent_open_pack(struct obd_export *exp, struct lookup_intent *it,
 	enum ldlm_mode		 mode;
 	int			 rc;
 	int repsize, repsize_estimate;
+	__u32 inline_size;
 
 	ENTRY;
 
@@ -358,6 +359,12 @@ mdc_intent_open_pack(struct obd_export *exp, struct lookup_intent *it,
 			     sizeof(struct niobuf_remote));
 	ptlrpc_request_set_replen(req);
 
+	/* Make room for the whole file if its size is known and small */
+	inline_size = obddev->u.cli.cl_dom_min_inline_repsize;
+	if (op_data->op_dom_open_size > inline_size &&
+	    op_data->op_dom_open_size <= obddev->u.cli.cl_dom_max_inline_repsize)
+		inline_size = op_data->op_dom_open_size;
+
 	/* Get real repbuf allocated size as rounded up power of 2 */
 	repsize = size_roundup_power2(req->rq_replen +
 				      lustre_msg_early_size());
@@ -368,9 +375,9 @@ mdc_intent_open_pack(struct obd_export *exp, struct lookup_intent *it,
 			   sizeof(struct lov_comp_md_entry_v1) +
 			   lov_mds_md_size(0, LOV_MAGIC_V3));
 
-	if (repsize_estimate < obddev->u.cli.cl_dom_min_inline_repsize) {
-		repsize = obddev->u.cli.cl_dom_min_inline_repsize -
-			  repsize_estimate + sizeof(struct niobuf_remote);
+	if (repsize_estimate < inline_size) {
+		repsize = inline_size - repsize_estimate +
+			  sizeof(struct niobuf_remote);
 		req_capsule_set_size(&req->rq_pill, &RMF_NIOBUF_INLINE,
 				     RCL_SERVER,
 				     sizeof(struct niobuf_remote) + repsize);
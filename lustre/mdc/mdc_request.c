@@ -2757,6 +2757,7 @@ int mdc_setup(struct obd_device *obd, struct lustre_cfg *cfg)
 		GOTO(err_osc_cleanup, rc);
 
 	obd->u.cli.cl_dom_min_inline_repsize = MDC_DOM_DEF_INLINE_REPSIZE;
+	obd->u.cli.cl_dom_max_inline_repsize = 0;
 
 	ns_register_cancel(obd->obd_namespace, mdc_cancel_weight);
 
@@ -209,9 +209,22 @@ out_trans:
 }
 EXPORT_SYMBOL(llog_destroy);
 
-/* returns negative on error; 0 if success; 1 if success & log destroyed */
-int llog_cancel_rec(const struct lu_env *env, struct llog_handle *loghandle,
-		    int index)
+/**
+ * Cancel several records of the same plain llog in one transaction.
+ *
+ * All bits are cleared under a single header update, so cancelling a
+ * batch of records costs one transaction instead of one per record.
+ *
+ * \param[in] env	execution environment
+ * \param[in] loghandle	llog handle of the plain llog
+ * \param[in] num	number of records in \a index
+ * \param[in] index	array of record indices to cancel
+ *
+ * \retval		negative on error; 0 if success;
+ *			LLOG_DEL_PLAIN if success & log destroyed
+ */
+int llog_cancel_arr_rec(const struct lu_env *env,
+			struct llog_handle *loghandle, int num, int *index)
 {
 	struct llog_thread_info *lgi = llog_info(env);
 	struct dt_device	*dt;
@@ -220,22 +233,26 @@ int llog_cancel_rec(const struct lu_env *env, struct llog_handle *loghandle,
 	__u32			 tmp_lgc_index;
 	int			 rc;
 	int rc1;
-	bool subtract_count = false;
+	int i;
+	int cleared = 0;
 
 	ENTRY;
 
 	LASSERT(loghandle != NULL);
 	LASSERT(loghandle->lgh_ctxt != NULL);
 	LASSERT(loghandle->lgh_obj != NULL);
+	LASSERT(num > 0);
 
 	llh = loghandle->lgh_hdr;
 
-	CDEBUG(D_RPCTRACE, "Canceling %d in log "DFID"\n", index,
-	       PFID(&loghandle->lgh_id.lgl_oi.oi_fid));
+	CDEBUG(D_RPCTRACE, "Canceling %d records starting at %d in log "DFID"\n",
+	       num, index[0], PFID(&loghandle->lgh_id.lgl_oi.oi_fid));
 
-	if (index == 0) {
-		CERROR("Can't cancel index 0 which is header\n");
-		RETURN(-EINVAL);
+	for (i = 0; i < num; i++) {
+		if (index[i] == 0) {
+			CERROR("Can't cancel index 0 which is header\n");
+			RETURN(-EINVAL);
+		}
 	}
 
 	dt = lu2dt_dev(loghandle->lgh_obj->do_lu.lo_dev);
@@ -247,7 +264,7 @@ int llog_cancel_rec(const struct lu_env *env, struct llog_handle *loghandle,
 	if (IS_ERR(th))
 		RETURN(PTR_ERR(th));
 
-	rc = llog_declare_write_rec(env, loghandle, &llh->llh_hdr, index, th);
+	rc = llog_declare_write_rec(env, loghandle, &llh->llh_hdr, 0, th);
 	if (rc < 0)
 		GOTO(out_trans, rc);
 
@@ -265,25 +282,37 @@ int llog_cancel_rec(const struct lu_env *env, struct llog_handle *loghandle,
 	down_write(&loghandle->lgh_lock);
 	/* clear bitmap */
 	mutex_lock(&loghandle->lgh_hdr_mutex);
-	if (!ext2_clear_bit(index, LLOG_HDR_BITMAP(llh))) {
-		CDEBUG(D_RPCTRACE, "Catalog index %u already clear?\n", index);
-		GOTO(out_unlock, rc);
+	for (i = 0; i < num; i++) {
+		if (!ext2_clear_bit(index[i], LLOG_HDR_BITMAP(llh))) {
+			CDEBUG(D_RPCTRACE, "Catalog index %u already clear?\n",
+			       index[i]);
+			/* mark it so the error path doesn't set it again */
+			index[i] = -index[i];
+			continue;
+		}
+		loghandle->lgh_hdr->llh_count--;
+		cleared++;
 	}
+	if (cleared == 0)
+		GOTO(out_unlock, rc = 0);
 
-	loghandle->lgh_hdr->llh_count--;
-	subtract_count = true;
-
-	/* Since llog_process_thread use lgi_cookie, it`s better to save them
-	 * and restore after using
-	 */
-	tmp_lgc_index = lgi->lgi_cookie.lgc_index;
-	/* Pass this index to llog_osd_write_rec(), which will use the index
-	 * to only update the necesary bitmap. */
-	lgi->lgi_cookie.lgc_index = index;
-	/* update header */
-	rc = llog_write_rec(env, loghandle, &llh->llh_hdr, &lgi->lgi_cookie,
-			    LLOG_HEADER_IDX, th);
-	lgi->lgi_cookie.lgc_index = tmp_lgc_index;
+	if (num == 1) {
+		/* Since llog_process_thread use lgi_cookie, it`s better to
+		 * save them and restore after using
+		 */
+		tmp_lgc_index = lgi->lgi_cookie.lgc_index;
+		/* Pass this index to llog_osd_write_rec(), which will use
+		 * the index to only update the necesary bitmap. */
+		lgi->lgi_cookie.lgc_index = index[0];
+		/* update header */
+		rc = llog_write_rec(env, loghandle, &llh->llh_hdr,
+				    &lgi->lgi_cookie, LLOG_HEADER_IDX, th);
+		lgi->lgi_cookie.lgc_index = tmp_lgc_index;
+	} else {
+		/* bits may be spread over the bitmap, write it whole */
+		rc = llog_write_rec(env, loghandle, &llh->llh_hdr, NULL,
+				    LLOG_HEADER_IDX, th);
+	}
 
 	if (rc != 0)
 		GOTO(out_unlock, rc);
@@ -317,14 +346,29 @@ out_trans:
 	rc1 = dt_trans_stop(env, dt, th);
 	if (rc == 0)
 		rc = rc1;
-	if (rc < 0 && subtract_count) {
+	if (rc < 0 && cleared > 0) {
 		mutex_lock(&loghandle->lgh_hdr_mutex);
-		loghandle->lgh_hdr->llh_count++;
-		ext2_set_bit(index, LLOG_HDR_BITMAP(llh));
+		for (i = 0; i < num; i++) {
+			if (index[i] <= 0)
+				continue;
+			loghandle->lgh_hdr->llh_count++;
+			ext2_set_bit(index[i], LLOG_HDR_BITMAP(llh));
+		}
 		mutex_unlock(&loghandle->lgh_hdr_mutex);
 	}
+	for (i = 0; i < num; i++)
+		if (index[i] < 0)
+			index[i] = -index[i];
 	RETURN(rc);
 }
+EXPORT_SYMBOL(llog_cancel_arr_rec);
+
+/* returns negative on error; 0 if success; 1 if success & log destroyed */
+int llog_cancel_rec(const struct lu_env *env, struct llog_handle *loghandle,
+		    int index)
+{
+	return llog_cancel_arr_rec(env, loghandle, 1, &index);
+}
 
 int llog_read_header(const struct lu_env *env, struct llog_handle *handle,
 		     const struct obd_uuid *uuid)
@@ -694,12 +694,21 @@ out_trans:
 }
 EXPORT_SYMBOL(llog_cat_add);
 
+static inline bool llog_cat_cookie_same_log(struct llog_cookie *a,
+					    struct llog_cookie *b)
+{
+	return memcmp(&a->lgc_lgl.lgl_oi, &b->lgc_lgl.lgl_oi,
+		      sizeof(a->lgc_lgl.lgl_oi)) == 0 &&
+	       a->lgc_lgl.lgl_ogen == b->lgc_lgl.lgl_ogen;
+}
+
 /* For each cookie in the cookie array, we clear the log in-use bit and either:
  * - the log is empty, so mark it free in the catalog header and delete it
  * - the log is not empty, just write out the log header
  *
  * The cookies may be in different log files, so we need to get new logs
- * each time.
+ * each time. Consecutive cookies of the same log are cancelled together
+ * in a single transaction.
  *
  * Assumes caller has already pushed us into the kernel context.
  */
@@ -708,21 +717,37 @@ int llog_cat_cancel_records(const struct lu_env *env,
 			    struct llog_cookie *cookies)
 {
 	int i, index, rc = 0, failed = 0;
+	int *indices = NULL;
+	int nr;
 
 	ENTRY;
 
-	for (i = 0; i < count; i++, cookies++) {
+	if (count > 1)
+		OBD_ALLOC(indices, count * sizeof(*indices));
+
+	for (i = 0; i < count; i += nr, cookies += nr) {
 		struct llog_handle *loghandle;
 		struct llog_logid *lgl = &cookies->lgc_lgl;
 		int  lrc;
 
+		nr = 1;
+		if (indices != NULL) {
+			indices[0] = cookies->lgc_index;
+			while (i + nr < count &&
+			       llog_cat_cookie_same_log(cookies,
+							&cookies[nr])) {
+				indices[nr] = cookies[nr].lgc_index;
+				nr++;
+			}
+		}
+
 		rc = llog_cat_id2handle(env, cathandle, &loghandle, lgl);
 		if (rc) {
 			CDEBUG(D_HA, "%s: cannot find llog for handle "DFID":%x"
 			       ": rc = %d\n",
 			       cathandle->lgh_ctxt->loc_obd->obd_name,
 			       PFID(&lgl->lgl_oi.oi_fid), lgl->lgl_ogen, rc);
-			failed++;
+			failed += nr;
 			continue;
 		}
 
@@ -738,13 +763,18 @@ int llog_cat_cancel_records(const struct lu_env *env,
 			       ": rc = %d\n",
 			       cathandle->lgh_ctxt->loc_obd->obd_name,
 			       PFID(&lgl->lgl_oi.oi_fid), lgl->lgl_ogen, lrc);
-			failed++;
+			failed += nr;
 			if (rc == 0)
 				rc = lrc;
+			llog_handle_put(env, loghandle);
 			continue;
 		}
 
-		lrc = llog_cancel_rec(env, loghandle, cookies->lgc_index);
+		if (nr > 1)
+			lrc = llog_cancel_arr_rec(env, loghandle, nr, indices);
+		else
+			lrc = llog_cancel_rec(env, loghandle,
+					      cookies->lgc_index);
 		if (lrc == LLOG_DEL_PLAIN) { /* log has been destroyed */
 			index = loghandle->u.phd.phd_cookie.lgc_index;
 			lrc = llog_cat_cleanup(env, cathandle, loghandle,
@@ -755,7 +785,7 @@ int llog_cat_cancel_records(const struct lu_env *env,
 			if (rc == 0) /* ENOENT shouldn't rewrite any error */
 				rc = lrc;
 		} else if (lrc < 0) {
-			failed++;
+			failed += nr;
 			if (rc == 0)
 				rc = lrc;
 		}
@@ -766,6 +796,9 @@ int llog_cat_cancel_records(const struct lu_env *env,
 		       cathandle->lgh_ctxt->loc_obd->obd_name, failed, count,
 		       rc);
 
+	if (indices != NULL)
+		OBD_FREE(indices, count * sizeof(*indices));
+
 	RETURN(rc);
 }
 EXPORT_SYMBOL(llog_cat_cancel_records);
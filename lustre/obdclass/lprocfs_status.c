@@ -2308,7 +2308,9 @@ ssize_t short_io_bytes_store(struct kobject *kobj, struct attribute *attr,
 	if (rc)
 		GOTO(out, rc);
 
-	if (val && (val < MIN_SHORT_IO_BYTES || val > OBD_MAX_SHORT_IO_BYTES))
+	/* writes are additionally limited to OBD_MAX_SHORT_IO_BYTES */
+	if (val && (val < MIN_SHORT_IO_BYTES ||
+		    val > OBD_MAX_SHORT_IO_READ_BYTES))
 		GOTO(out, rc = -ERANGE);
 
 	rc = count;
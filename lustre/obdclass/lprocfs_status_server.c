@@ -690,6 +690,17 @@ int lprocfs_recovery_status_seq_show(struct seq_file *m, void *data)
 
 	/* sampled unlocked, but really... */
 	if (obd->obd_recovering == 0) {
+		struct target_recovery_data *trd = &obd->obd_recovery_data;
+		__u64 final_ping_ms = trd->trd_final_ping_ms;
+
+		/* the final pings are handled after obd_recovering is
+		 * cleared, report the time spent so far while they are */
+		if (trd->trd_processing_task != 0 &&
+		    ktime_to_ns(trd->trd_final_ping_start) != 0 &&
+		    final_ping_ms == 0)
+			final_ping_ms = ktime_ms_delta(ktime_get(),
+						trd->trd_final_ping_start);
+
 		seq_printf(m, "COMPLETE\n");
 		seq_printf(m, "recovery_start: %lld\n",
 			   (s64)obd->obd_recovery_start);
@@ -704,6 +715,16 @@ int lprocfs_recovery_status_seq_show(struct seq_file *m, void *data)
 			   atomic_read(&obd->obd_max_recoverable_clients));
 		seq_printf(m, "replayed_requests: %d\n",
 			   obd->obd_replayed_requests);
+		seq_printf(m, "replayed_locks: %d\n",
+			   obd->obd_replayed_locks);
+		seq_printf(m, "lock_replay_threads: %d\n",
+			   trd->trd_lock_replay_workers);
+		/* time spent in each recovery stage */
+		seq_printf(m, "req_replay_time_ms: %llu\n",
+			   trd->trd_req_replay_ms);
+		seq_printf(m, "lock_replay_time_ms: %llu\n",
+			   trd->trd_lock_replay_ms);
+		seq_printf(m, "final_ping_time_ms: %llu\n", final_ping_ms);
 		seq_printf(m, "last_transno: %lld\n",
 			   obd->obd_next_recovery_transno - 1);
 		seq_printf(m, "VBR: %s\n", obd->obd_version_recov ?
@@ -897,6 +897,12 @@ static int osc_stats_seq_show(struct seq_file *seq, void *v)
 		   stats->os_lockless_reads);
 	seq_printf(seq, "lockless_truncate\t\t%llu\n",
 		   stats->os_lockless_truncates);
+	seq_printf(seq, "short_io_read_rpcs\t\t%llu\n",
+		   stats->os_short_io_reads);
+	seq_printf(seq, "short_io_write_rpcs\t\t%llu\n",
+		   stats->os_short_io_writes);
+	seq_printf(seq, "loi_list_lock_contended\t\t%ld\n",
+		   atomic_long_read(&dev->u.cli.cl_loi_list_contended));
 	return 0;
 }
 
@@ -909,6 +915,7 @@ static ssize_t osc_stats_seq_write(struct file *file,
         struct osc_stats *stats = &obd2osc_dev(dev)->od_stats;
 
         memset(stats, 0, sizeof(*stats));
+	atomic_long_set(&dev->u.cli.cl_loi_list_contended, 0);
         return len;
 }
 
@@ -1396,6 +1396,19 @@ static int osc_completion(const struct lu_env *env, struct osc_async_page *oap,
 	       atomic_read(&__tmp->cl_lru_shrinkers), ##args);		\
 } while (0)
 
+/**
+ * Take cl_loi_list_lock. Acquisitions which find the lock busy are counted
+ * so that the contention on the per-client lists and grant can be observed
+ * through osc_stats.
+ */
+static inline void osc_cli_lock(struct client_obd *cli)
+{
+	if (unlikely(!spin_trylock(&cli->cl_loi_list_lock))) {
+		atomic_long_inc(&cli->cl_loi_list_contended);
+		spin_lock(&cli->cl_loi_list_lock);
+	}
+}
+
 /* caller must hold loi_list_lock */
 static void osc_consume_write_grant(struct client_obd *cli,
 				    struct brw_page *pga)
@@ -1467,7 +1480,7 @@ static void __osc_unreserve_grant(struct client_obd *cli,
 static void osc_unreserve_grant(struct client_obd *cli,
 				unsigned int reserved, unsigned int unused)
 {
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 	__osc_unreserve_grant(cli, reserved, unused);
 	if (unused > 0)
 		osc_wake_cache_waiters(cli);
@@ -1494,7 +1507,7 @@ static void osc_free_grant(struct client_obd *cli, unsigned int nr_pages,
 
 	grant = (1 << cli->cl_chunkbits) + cli->cl_grant_extent_tax;
 
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 	atomic_long_sub(nr_pages, &obd_dirty_pages);
 	cli->cl_dirty_pages -= nr_pages;
 	cli->cl_lost_grant += lost_grant;
@@ -1519,7 +1532,7 @@ static void osc_free_grant(struct client_obd *cli, unsigned int nr_pages,
  */
 static void osc_exit_cache(struct client_obd *cli, struct osc_async_page *oap)
 {
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 	osc_release_write_grant(cli, &oap->oap_brw_page);
 	spin_unlock(&cli->cl_loi_list_lock);
 }
@@ -1552,6 +1565,64 @@ static int osc_enter_cache_try(struct client_obd *cli,
 	return 0;
 }
 
+/**
+ * Dirty a page which is already covered by the grant of the active extent.
+ *
+ * Dirty page accounting for the rest of the extent, up to @npages, is
+ * reserved in one go and kept in osc_io::oi_dirty_reserved, so that the
+ * following pages of the same extent are added into cache without taking
+ * cl_loi_list_lock. Unused reservation is returned by osc_dirty_unreserve().
+ */
+static int osc_enter_cache_extent(struct client_obd *cli, struct osc_io *oio,
+				  struct osc_async_page *oap,
+				  unsigned long npages)
+{
+	int rc = 1;
+
+	if (oio->oi_dirty_reserved == 0) {
+		osc_cli_lock(cli);
+		if (npages > 1 &&
+		    cli->cl_dirty_pages + npages <= cli->cl_dirty_max_pages) {
+			if (atomic_long_add_return(npages, &obd_dirty_pages) <=
+			    obd_max_dirty_pages) {
+				cli->cl_dirty_pages += npages;
+				oio->oi_dirty_reserved = npages;
+				osc_update_next_shrink(cli);
+			} else {
+				atomic_long_sub(npages, &obd_dirty_pages);
+			}
+		}
+		/* fall back to per-page accounting */
+		if (oio->oi_dirty_reserved == 0)
+			rc = osc_enter_cache_try(cli, oap, 0);
+		spin_unlock(&cli->cl_loi_list_lock);
+		if (oio->oi_dirty_reserved == 0)
+			return rc;
+	}
+
+	LASSERT(!(oap->oap_brw_flags & OBD_BRW_FROM_GRANT));
+	oio->oi_dirty_reserved--;
+	oap->oap_brw_flags |= OBD_BRW_FROM_GRANT;
+	return rc;
+}
+
+/**
+ * Return the dirty pages reserved by osc_enter_cache_extent() but not used.
+ */
+void osc_dirty_unreserve(struct client_obd *cli, struct osc_io *oio)
+{
+	if (oio->oi_dirty_reserved == 0)
+		return;
+
+	osc_cli_lock(cli);
+	atomic_long_sub(oio->oi_dirty_reserved, &obd_dirty_pages);
+	cli->cl_dirty_pages -= oio->oi_dirty_reserved;
+	oio->oi_dirty_reserved = 0;
+	osc_wake_cache_waiters(cli);
+	spin_unlock(&cli->cl_loi_list_lock);
+}
+EXPORT_SYMBOL(osc_dirty_unreserve);
+
 /* Following two inlines exist to pass code fragments
  * to wait_event_idle_exclusive_timeout_cmd().  Passing
  * code fragments as macro args can look confusing, so
@@ -1570,7 +1641,7 @@ static inline void cli_unlock_and_unplug(const struct lu_env *env,
 
 static inline void cli_lock_after_unplug(struct client_obd *cli)
 {
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 }
 /**
  * The main entry to reserve dirty page accounting. Usually the grant reserved
@@ -1602,7 +1673,7 @@ static int osc_enter_cache(const struct lu_env *env, struct client_obd *cli,
 
 	OSC_DUMP_GRANT(D_CACHE, cli, "need:%d\n", bytes);
 
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 
 	/* force the caller to try sync io.  this can jump the list
 	 * of queued writes and create a discontiguous rpc stream */
@@ -1775,7 +1846,7 @@ static int osc_list_maint(struct client_obd *cli, struct osc_object *osc)
 {
 	int is_ready;
 
-	spin_lock(&cli->cl_loi_list_lock);
+	osc_cli_lock(cli);
 	is_ready = __osc_list_maint(cli, osc);
 	spin_unlock(&cli->cl_loi_list_lock);
 
@@ -1827,7 +1898,7 @@ static void osc_ap_completion(const struct lu_env *env, struct client_obd *cli,
 	oap->oap_interrupted = 0;
 
 	if (oap->oap_cmd & OBD_BRW_WRITE && xid > 0) {
-		spin_lock(&cli->cl_loi_list_lock);
+		osc_cli_lock(cli);
 		osc_process_ar(&cli->cl_ar, xid, rc);
 		osc_process_ar(&loi->loi_ar, xid, rc);
 		spin_unlock(&cli->cl_loi_list_lock);
@@ -2267,7 +2338,7 @@ __must_hold(&cli->cl_loi_list_lock)
 		lu_object_ref_del_at(&obj->co_lu, &link, "check", current);
 		cl_object_put(env, obj);
 
-		spin_lock(&cli->cl_loi_list_lock);
+		osc_cli_lock(cli);
 	}
 }
 
@@ -2280,7 +2351,7 @@ int osc_io_unplug0(const struct lu_env *env, struct client_obd *cli,
 		return 0;
 
 	if (!async) {
-		spin_lock(&cli->cl_loi_list_lock);
+		osc_cli_lock(cli);
 		osc_check_rpcs(env, cli);
 		spin_unlock(&cli->cl_loi_list_lock);
 	} else {
@@ -2403,10 +2474,16 @@ int osc_queue_async_io(const struct lu_env *env, struct cl_io *io,
 		if (ext->oe_end >= index)
 			grants = 0;
 
-		/* it doesn't need any grant to dirty this page */
-		spin_lock(&cli->cl_loi_list_lock);
-		rc = osc_enter_cache_try(cli, oap, grants);
-		spin_unlock(&cli->cl_loi_list_lock);
+		if (grants == 0) {
+			/* it doesn't need any grant to dirty this page */
+			rc = osc_enter_cache_extent(cli, oio, oap,
+						    ext->oe_end - index + 1);
+		} else {
+			osc_dirty_unreserve(cli, oio);
+			osc_cli_lock(cli);
+			rc = osc_enter_cache_try(cli, oap, grants);
+			spin_unlock(&cli->cl_loi_list_lock);
+		}
 		if (rc == 0) { /* try failed */
 			grants = 0;
 			need_release = 1;
@@ -2436,6 +2513,8 @@ int osc_queue_async_io(const struct lu_env *env, struct cl_io *io,
 	}
 
 	if (ext == NULL) {
+		/* don't hold dirty pages of the old extent while waiting */
+		osc_dirty_unreserve(cli, oio);
 		tmp = (1 << cli->cl_chunkbits) + cli->cl_grant_extent_tax;
 
 		/* try to find new extent to cover this page */
@@ -2730,7 +2809,7 @@ int osc_queue_sync_pages(const struct lu_env *env, const struct cl_io *io,
 		grants += (1 << cli->cl_chunkbits) *
 			((page_count + ppc - 1) / ppc);
 
-		spin_lock(&cli->cl_loi_list_lock);
+		osc_cli_lock(cli);
 		if (osc_reserve_grant(cli, grants) == 0) {
 			list_for_each_entry(oap, list, oap_pending_item) {
 				osc_consume_write_grant(cli,
@@ -966,6 +966,7 @@ void osc_io_end(const struct lu_env *env, const struct cl_io_slice *slice)
 {
 	struct osc_io *oio = cl2osc_io(env, slice);
 
+	osc_dirty_unreserve(osc_cli(cl2osc(slice->cis_obj)), oio);
 	if (oio->oi_active) {
 		osc_extent_release(env, oio->oi_active);
 		oio->oi_active = NULL;
@@ -60,6 +60,10 @@ module_param(osc_reqpool_mem_max, uint, 0444);
 static int osc_idle_timeout = 20;
 module_param(osc_idle_timeout, uint, 0644);
 
+/* run writeback of different OSCs on ptlrpcd threads of different CPTs */
+static int osc_writeback_spread = 1;
+module_param(osc_writeback_spread, int, 0444);
+
 #define osc_grant_args osc_brw_async_args
 
 struct osc_setattr_args {
@@ -1346,9 +1350,12 @@ osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 	for (i = 0; i < page_count; i++)
 		short_io_size += pga[i]->count;
 
-	/* Check if read/write is small enough to be a short io. */
+	/* Check if read/write is small enough to be a short io. The data of
+	 * a short write travels in the request buffer, which limits its size
+	 * further, the data of a short read comes back in the reply. */
 	if (short_io_size > cli->cl_max_short_io_bytes || niocount > 1 ||
-	    !imp_connect_shortio(cli->cl_import))
+	    !imp_connect_shortio(cli->cl_import) ||
+	    (opc == OST_WRITE && short_io_size > OBD_MAX_SHORT_IO_BYTES))
 		short_io_size = 0;
 
 	req_capsule_set_size(pill, &RMF_SHORT_IO, RCL_CLIENT,
@@ -1370,6 +1377,13 @@ osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 	req->rq_no_retry_einprogress = 1;
 
 	if (short_io_size != 0) {
+		struct osc_stats *stats =
+			&obd2osc_dev(cli->cl_import->imp_obd)->od_stats;
+
+		if (opc == OST_READ)
+			stats->os_short_io_reads++;
+		else
+			stats->os_short_io_writes++;
 		desc = NULL;
 		short_io_buf = NULL;
 		goto no_bulk;
@@ -3207,6 +3221,12 @@ int osc_setup_common(struct obd_device *obd, struct lustre_cfg *lcfg)
 	if (IS_ERR(handler))
 		GOTO(out_ptlrpcd_work, rc = PTR_ERR(handler));
 	cli->cl_writeback_work = handler;
+	/* build and checksum the write RPCs of different OSTs in parallel
+	 * instead of on the CPT of the writing process only */
+	if (osc_writeback_spread)
+		ptlrpcd_work_set_cpt(handler,
+				     obd->obd_minor %
+				     cfs_cpt_number(cfs_cpt_table));
 
 	handler = ptlrpcd_alloc_work(cli->cl_import, lru_queue_work, cli);
 	if (IS_ERR(handler))
@@ -140,6 +140,52 @@ static ssize_t sync_in_progress_show(struct kobject *kobj,
 }
 LUSTRE_RO_ATTR(sync_in_progress);
 
+/**
+ * Show number of llog records cancelled after their changes were
+ * committed on OST, and the number of batches they were cancelled in
+ *
+ * \param[in] kobj	kobject of the OSP device
+ * \param[in] attr	attribute being read, unused
+ * \param[out] buf	buffer the value is printed to
+ *
+ * \retval		number of bytes printed
+ */
+static ssize_t sync_cancelled_show(struct kobject *kobj,
+				   struct attribute *attr,
+				   char *buf)
+{
+	struct dt_device *dt = container_of(kobj, struct dt_device,
+					    dd_kobj);
+	struct osp_device *osp = dt2osp_dev(dt);
+
+	return sprintf(buf, "%lld %lld\n",
+		       (s64)atomic64_read(&osp->opd_sync_cancelled_recs),
+		       (s64)atomic64_read(&osp->opd_sync_cancel_batches));
+}
+LUSTRE_RO_ATTR(sync_cancelled);
+
+/**
+ * Show rate of llog records cancelled per second, sampled over the
+ * last second the sync thread was cancelling records
+ *
+ * \param[in] kobj	kobject of the OSP device
+ * \param[in] attr	attribute being read, unused
+ * \param[out] buf	buffer the value is printed to
+ *
+ * \retval		number of bytes printed
+ */
+static ssize_t sync_drain_rate_show(struct kobject *kobj,
+				    struct attribute *attr,
+				    char *buf)
+{
+	struct dt_device *dt = container_of(kobj, struct dt_device,
+					    dd_kobj);
+	struct osp_device *osp = dt2osp_dev(dt);
+
+	return sprintf(buf, "%lu\n", osp->opd_sync_drain_rate);
+}
+LUSTRE_RO_ATTR(sync_drain_rate);
+
 /**
  * Show number of changes to sync
  *
@@ -319,6 +365,9 @@ static ssize_t create_count_show(struct kobject *kobj,
 /**
  * Change number of objects to precreate next time
  *
+ * The precreate window adapts to the create rate, the value set here is
+ * kept as the smallest window it may shrink to.
+ *
  * \param[in] file	proc file
  * \param[in] buffer	string which represents number of objects to precreate
  * \param[in] count	\a buffer length
@@ -360,7 +409,9 @@ static ssize_t create_count_store(struct kobject *kobj, struct attribute *attr,
 
 	for (i = 1; (i << 1) <= val; i <<= 1)
 		;
+	/* OST_MIN_PRECREATE leaves the window fully adaptive */
 	osp->opd_pre_create_count = i;
+	osp->opd_pre_create_floor = i;
 
 	return count;
 }
@@ -917,6 +968,82 @@ osp_reserved_mb_low_seq_write(struct file *file, const char __user *buffer,
 }
 LDEBUGFS_SEQ_FOPS(osp_reserved_mb_low);
 
+/**
+ * Show the state of the precreate window controller and the histogram of
+ * the time creates waited for precreated objects
+ *
+ * \param[in] m		seq_file handle
+ * \param[in] data	unused for single entry
+ * \retval		0 on success
+ * \retval		negative number on error
+ */
+static int osp_precreate_stats_seq_show(struct seq_file *m, void *data)
+{
+	struct obd_device	*dev = m->private;
+	struct osp_device	*osp = lu2osp_dev(dev->obd_lu_dev);
+	struct obd_histogram	*hist;
+	struct timespec64	 now;
+	unsigned long		 tot, cum = 0;
+	int			 i;
+
+	if (osp == NULL || osp->opd_pre == NULL)
+		return -EINVAL;
+
+	ktime_get_real_ts64(&now);
+	hist = &osp->opd_pre_stall_hist;
+	tot = lprocfs_oh_sum(hist);
+
+	seq_printf(m, "snapshot_time:         %lld.%09lu (secs.nsecs)\n",
+		   (s64)now.tv_sec, now.tv_nsec);
+	seq_printf(m, "create_count:          %d\n",
+		   osp->opd_pre_create_count);
+	seq_printf(m, "objects_consumed:      %llu\n",
+		   osp->opd_pre_consumed);
+	seq_printf(m, "consume_rate:          %u objs/s\n",
+		   osp->opd_pre_rate);
+	seq_printf(m, "precreate_rpc_time:    %u ms\n",
+		   osp->opd_pre_rpc_ms);
+	seq_printf(m, "create_stalls:         %lu\n", tot);
+
+	seq_printf(m, "\nstall time (ms)       stalls   %% cum %%\n");
+	for (i = 0; i < OBD_HIST_MAX && cum < tot; i++) {
+		unsigned long n = hist->oh_buckets[i];
+
+		cum += n;
+		seq_printf(m, "%lu:\t\t%10lu %3u %3u\n",
+			   1UL << i, n, pct(n, tot), pct(cum, tot));
+	}
+
+	return 0;
+}
+
+/**
+ * Clear the stall histogram
+ *
+ * \param[in] file	proc file
+ * \param[in] buffer	unused
+ * \param[in] count	\a buffer length
+ * \param[in] off	unused for single entry
+ * \retval		\a count on success
+ * \retval		negative number on error
+ */
+static ssize_t
+osp_precreate_stats_seq_write(struct file *file, const char __user *buffer,
+			      size_t count, loff_t *off)
+{
+	struct seq_file		*m = file->private_data;
+	struct obd_device	*dev = m->private;
+	struct osp_device	*osp = lu2osp_dev(dev->obd_lu_dev);
+
+	if (osp == NULL || osp->opd_pre == NULL)
+		return -EINVAL;
+
+	lprocfs_oh_clear(&osp->opd_pre_stall_hist);
+
+	return count;
+}
+LDEBUGFS_SEQ_FOPS(osp_precreate_stats);
+
 static ssize_t force_sync_store(struct kobject *kobj, struct attribute *attr,
 				const char *buffer, size_t count)
 {
@@ -951,6 +1078,8 @@ static struct lprocfs_vars lprocfs_osp_obd_vars[] = {
 	  .fops =	&osp_reserved_mb_high_fops	},
 	{ .name =	"reserved_mb_low",
 	  .fops =	&osp_reserved_mb_low_fops	},
+	{ .name =	"precreate_stats",
+	  .fops =	&osp_precreate_stats_fops	},
 	{ NULL }
 };
 
@@ -987,6 +1116,8 @@ static struct attribute *osp_obd_attrs[] = {
 	&lustre_attr_sync_in_flight.attr,
 	&lustre_attr_sync_in_progress.attr,
 	&lustre_attr_sync_changes.attr,
+	&lustre_attr_sync_cancelled.attr,
+	&lustre_attr_sync_drain_rate.attr,
 	&lustre_attr_force_sync.attr,
 	&lustre_attr_old_sync_processed.attr,
 	&lustre_attr_create_count.attr,
@@ -80,12 +80,25 @@ struct osp_precreate {
 	int				 osp_pre_status;
 	/* how many objects to precreate next time */
 	int				 osp_pre_create_count;
+	/* create_count set by hand, the window doesn't shrink below it */
+	int				 osp_pre_create_floor;
 	int				 osp_pre_min_create_count;
 	int				 osp_pre_max_create_count;
 	/* whether to increase precreation window next time or not */
 	int				 osp_pre_create_slow;
 	/* cleaning up orphans or recreating missing objects */
 	int				 osp_pre_recovering;
+	/* objects handed out to creates so far */
+	__u64				 osp_pre_consumed;
+	/* consumed count and time of the last rate sample */
+	__u64				 osp_pre_rate_consumed;
+	ktime_t				 osp_pre_rate_stamp;
+	/* estimated objects consumed per second */
+	unsigned int			 osp_pre_rate;
+	/* average latency of a precreate RPC, in milliseconds */
+	unsigned int			 osp_pre_rpc_ms;
+	/* time creates waited for precreated objects, in milliseconds */
+	struct obd_histogram		 osp_pre_stall_hist;
 };
 
 struct osp_update_request_sub {
@@ -239,6 +252,15 @@ struct osp_device {
 	int                              opd_sync_last_catalog_idx;
 	/* number of processed records */
 	atomic64_t			 opd_sync_processed_recs;
+	/* cookies of committed records, cancelled in batches */
+	struct llog_cookie		*opd_sync_cancel_cookies;
+	/* number of cancelled records and of cancel batches */
+	atomic64_t			 opd_sync_cancelled_recs;
+	atomic64_t			 opd_sync_cancel_batches;
+	/* records cancelled per second over the last sampling window */
+	unsigned long			 opd_sync_drain_rate;
+	__u64				 opd_sync_drain_recs;
+	ktime_t				 opd_sync_drain_stamp;
 	/* stop processing new requests until barrier=0 */
 	atomic_t			 opd_sync_barrier;
 	wait_queue_head_t		 opd_sync_barrier_waitq;
@@ -283,10 +305,17 @@ struct osp_device {
 #define opd_pre_user_waitq		opd_pre->osp_pre_user_waitq
 #define opd_pre_status			opd_pre->osp_pre_status
 #define opd_pre_create_count		opd_pre->osp_pre_create_count
+#define opd_pre_create_floor		opd_pre->osp_pre_create_floor
 #define opd_pre_min_create_count	opd_pre->osp_pre_min_create_count
 #define opd_pre_max_create_count	opd_pre->osp_pre_max_create_count
 #define opd_pre_create_slow		opd_pre->osp_pre_create_slow
 #define opd_pre_recovering		opd_pre->osp_pre_recovering
+#define opd_pre_consumed		opd_pre->osp_pre_consumed
+#define opd_pre_rate_consumed		opd_pre->osp_pre_rate_consumed
+#define opd_pre_rate_stamp		opd_pre->osp_pre_rate_stamp
+#define opd_pre_rate			opd_pre->osp_pre_rate
+#define opd_pre_rpc_ms			opd_pre->osp_pre_rpc_ms
+#define opd_pre_stall_hist		opd_pre->osp_pre_stall_hist
 
 extern struct kmem_cache *osp_object_kmem;
 
@@ -592,6 +592,78 @@ static int osp_precreate_fids(const struct lu_env *env, struct osp_device *osp,
 	return *grow > 0 ? 0 : 1;
 }
 
+/*
+ * The precreate window is sized to cover the objects consumed during
+ * OSP_PRE_WINDOW_RPCS precreate round trips. As a new precreate is sent once
+ * half of the window is left, a refill is normally back well before the
+ * pool runs dry.
+ */
+#define OSP_PRE_WINDOW_RPCS	4
+/* shortest interval the consume rate is sampled over */
+#define OSP_PRE_RATE_MIN_MS	100
+
+/**
+ * Update the estimate of the object consume rate
+ *
+ * The rate follows a rise immediately, so a burst of creates grows the
+ * window on the next precreate, and decays slowly when creates slow down.
+ * Called with opd_pre_lock held.
+ *
+ * \param[in] d		OSP device
+ */
+static void osp_precreate_update_rate(struct osp_device *d)
+{
+	ktime_t now = ktime_get();
+	s64 ms = ktime_ms_delta(now, d->opd_pre_rate_stamp);
+	unsigned int rate;
+
+	if (ms < OSP_PRE_RATE_MIN_MS)
+		return;
+
+	rate = div64_s64((d->opd_pre_consumed - d->opd_pre_rate_consumed) *
+			 MSEC_PER_SEC, ms);
+	if (rate >= d->opd_pre_rate)
+		d->opd_pre_rate = rate;
+	else
+		d->opd_pre_rate = (d->opd_pre_rate * 3 + rate) / 4;
+
+	d->opd_pre_rate_consumed = d->opd_pre_consumed;
+	d->opd_pre_rate_stamp = now;
+}
+
+/**
+ * Size the precreate window from the consume rate and RPC latency
+ *
+ * The window grows straight to the size the measured demand needs, unless
+ * the OST could not keep up with the last request. It shrinks by half at
+ * most per precreate once the demand drops well below it, but not below a
+ * create_count set by the administrator.
+ * Called with opd_pre_lock held.
+ *
+ * \param[in] d		OSP device
+ */
+static void osp_precreate_update_window(struct osp_device *d)
+{
+	u64 want;
+
+	osp_precreate_update_rate(d);
+
+	want = (u64)d->opd_pre_rate * max(d->opd_pre_rpc_ms, 1U) *
+	       OSP_PRE_WINDOW_RPCS;
+	want = min_t(u64, div_u64(want, MSEC_PER_SEC),
+		     d->opd_pre_max_create_count / 2);
+	want = max_t(u64, want, d->opd_pre_min_create_count);
+	want = max_t(u64, want, d->opd_pre_create_floor);
+
+	if (want > d->opd_pre_create_count) {
+		if (d->opd_pre_create_slow == 0)
+			d->opd_pre_create_count = want;
+	} else if (want * 4 < d->opd_pre_create_count) {
+		d->opd_pre_create_count = max_t(int, want,
+						d->opd_pre_create_count / 2);
+	}
+}
+
 /**
  * Prepare and send precreate RPC
  *
@@ -615,6 +687,7 @@ static int osp_precreate_send(const struct lu_env *env, struct osp_device *d)
 	struct ost_body		*body;
 	int			 rc, grow, diff;
 	struct lu_fid		*fid = &oti->osi_fid;
+	ktime_t			 start;
 	ENTRY;
 
 	/* don't precreate new objects till OST healthy and has free space */
@@ -645,6 +718,7 @@ static int osp_precreate_send(const struct lu_env *env, struct osp_device *d)
 	}
 
 	spin_lock(&d->opd_pre_lock);
+	osp_precreate_update_window(d);
 	if (d->opd_pre_create_count > d->opd_pre_max_create_count / 2)
 		d->opd_pre_create_count = d->opd_pre_max_create_count / 2;
 	grow = d->opd_pre_create_count;
@@ -674,6 +748,8 @@ static int osp_precreate_send(const struct lu_env *env, struct osp_device *d)
 	if (OBD_FAIL_CHECK(OBD_FAIL_OSP_FAKE_PRECREATE))
 		GOTO(ready, rc = 0);
 
+	start = ktime_get();
+	OBD_FAIL_TIMEOUT(OBD_FAIL_OSP_PRECREATE_DELAY, cfs_fail_val);
 	rc = ptlrpc_queue_wait(req);
 	if (rc) {
 		CERROR("%s: can't precreate: rc = %d\n", d->opd_obd->obd_name,
@@ -682,6 +758,13 @@ static int osp_precreate_send(const struct lu_env *env, struct osp_device *d)
 	}
 	LASSERT(req->rq_transno == 0);
 
+	/* only this thread updates the latency, no locking needed */
+	if (d->opd_pre_rpc_ms == 0)
+		d->opd_pre_rpc_ms = ktime_ms_delta(ktime_get(), start);
+	else
+		d->opd_pre_rpc_ms = (d->opd_pre_rpc_ms * 3 +
+				     ktime_ms_delta(ktime_get(), start)) / 4;
+
 	body = req_capsule_server_get(&req->rq_pill, &RMF_OST_BODY);
 	if (body == NULL)
 		GOTO(out_req, rc = -EPROTO);
@@ -1443,6 +1526,7 @@ int osp_precreate_reserve(const struct lu_env *env, struct osp_device *d)
 {
 	time64_t expire = ktime_get_seconds() + obd_timeout;
 	struct l_wait_info lwi;
+	ktime_t stall_start = ktime_set(0, 0);
 	int precreated, rc, synced = 0;
 
 	ENTRY;
@@ -1529,10 +1613,17 @@ int osp_precreate_reserve(const struct lu_env *env, struct osp_device *d)
 			break;
 		}
 
+		if (ktime_to_ns(stall_start) == 0)
+			stall_start = ktime_get();
 		l_wait_event(d->opd_pre_user_waitq,
 			     osp_precreate_ready_condition(env, d), &lwi);
 	}
 
+	if (ktime_to_ns(stall_start) != 0)
+		lprocfs_oh_tally_log2(&d->opd_pre_stall_hist,
+				      ktime_ms_delta(ktime_get(),
+						     stall_start));
+
 	RETURN(rc);
 }
 
@@ -1588,6 +1679,7 @@ int osp_precreate_get_fid(const struct lu_env *env, struct osp_device *d,
 	d->opd_pre_used_fid.f_oid++;
 	memcpy(fid, &d->opd_pre_used_fid, sizeof(*fid));
 	d->opd_pre_reserved--;
+	d->opd_pre_consumed++;
 	/*
 	 * last_used_id must be changed along with getting new id otherwise
 	 * we might miscalculate gap causing object loss or leak
@@ -1742,6 +1834,8 @@ int osp_init_precreate(struct osp_device *d)
 	d->opd_pre_create_count = OST_MIN_PRECREATE;
 	d->opd_pre_min_create_count = OST_MIN_PRECREATE;
 	d->opd_pre_max_create_count = OST_MAX_PRECREATE;
+	d->opd_pre_rate_stamp = ktime_get();
+	spin_lock_init(&d->opd_pre_stall_hist.oh_lock);
 	d->opd_reserved_mb_high = 0;
 	d->opd_reserved_mb_low = 0;
 
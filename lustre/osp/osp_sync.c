@@ -40,6 +40,7 @@
 #define DEBUG_SUBSYSTEM S_MDS
 
 #include <linux/kthread.h>
+#include <linux/sort.h>
 #include <lustre_log.h>
 #include <lustre_update.h>
 #include "osp_internal.h"
@@ -83,6 +84,8 @@
 #define OSP_SYNC_THRESHOLD		10
 #define OSP_MAX_RPCS_IN_FLIGHT		8
 #define OSP_MAX_RPCS_IN_PROGRESS	4096
+/* committed llog records cancelled in one go */
+#define OSP_SYNC_CANCEL_BATCH		64
 
 #define OSP_JOB_MAGIC		0x26112005
 
@@ -995,6 +998,72 @@ static void osp_sync_process_record(const struct lu_env *env,
 	RETURN_EXIT;
 }
 
+static int osp_sync_cookie_cmp(const void *a, const void *b)
+{
+	const struct llog_cookie *c1 = a;
+	const struct llog_cookie *c2 = b;
+	int rc;
+
+	rc = memcmp(&c1->lgc_lgl.lgl_oi, &c2->lgc_lgl.lgl_oi,
+		    sizeof(c1->lgc_lgl.lgl_oi));
+	if (rc != 0)
+		return rc;
+	if (c1->lgc_lgl.lgl_ogen != c2->lgc_lgl.lgl_ogen)
+		return c1->lgc_lgl.lgl_ogen < c2->lgc_lgl.lgl_ogen ? -1 : 1;
+	if (c1->lgc_index != c2->lgc_index)
+		return c1->lgc_index < c2->lgc_index ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Cancel a batch of committed llog records.
+ *
+ * The cookies are sorted so that records of the same plain llog are
+ * adjacent and llog_cat_cancel_records() can clear them in a single
+ * transaction per llog.
+ *
+ * \param[in] env	LU environment provided by the caller
+ * \param[in] d		OSP device
+ * \param[in] llh	catalog handle
+ * \param[in] cookies	cookies of the records to cancel
+ * \param[in] count	number of cookies
+ */
+static void osp_sync_cancel_batch(const struct lu_env *env,
+				  struct osp_device *d,
+				  struct llog_handle *llh,
+				  struct llog_cookie *cookies, int count)
+{
+	ktime_t now;
+	s64 ms;
+	int rc;
+
+	if (count == 0)
+		return;
+
+	if (count > 1)
+		sort(cookies, count, sizeof(*cookies), osp_sync_cookie_cmp,
+		     NULL);
+
+	rc = llog_cat_cancel_records(env, llh, count, cookies);
+	if (rc)
+		CERROR("%s: can't cancel %d records: rc = %d\n",
+		       d->opd_obd->obd_name, count, rc);
+
+	atomic64_add(count, &d->opd_sync_cancelled_recs);
+	atomic64_inc(&d->opd_sync_cancel_batches);
+
+	/* only the sync thread gets here, no locking needed */
+	d->opd_sync_drain_recs += count;
+	now = ktime_get();
+	ms = ktime_ms_delta(now, d->opd_sync_drain_stamp);
+	if (ms >= MSEC_PER_SEC) {
+		d->opd_sync_drain_rate = div64_s64(d->opd_sync_drain_recs *
+						   MSEC_PER_SEC, ms);
+		d->opd_sync_drain_recs = 0;
+		d->opd_sync_drain_stamp = now;
+	}
+}
+
 /**
  * Cancel llog records for the committed changes.
  *
@@ -1014,8 +1083,9 @@ static void osp_sync_process_committed(const struct lu_env *env,
 	struct ptlrpc_request	*req;
 	struct llog_ctxt	*ctxt;
 	struct llog_handle	*llh;
+	struct llog_cookie	*cookies = d->opd_sync_cancel_cookies;
 	struct list_head	 list;
-	int			 rc, done = 0;
+	int			 done = 0, count = 0;
 
 	ENTRY;
 
@@ -1033,9 +1103,7 @@ static void osp_sync_process_committed(const struct lu_env *env,
 		osp_statfs_need_now(d);
 
 	/*
-	 * now cancel them all
-	 * XXX: can we improve this using some batching?
-	 *      with batch RPC that'll happen automatically?
+	 * now cancel them all, in batches of OSP_SYNC_CANCEL_BATCH records
 	 * XXX: can we store ctxt in lod_device and save few cycles ?
 	 */
 	ctxt = llog_get_context(obd, LLOG_MDS_OST_ORIG_CTXT);
@@ -1065,19 +1133,24 @@ static void osp_sync_process_committed(const struct lu_env *env,
 		LASSERT(body);
 		/* import can be closing, thus all commit cb's are
 		 * called we can check committness directly */
-		if (req->rq_import_generation == imp->imp_generation) {
-			rc = llog_cat_cancel_records(env, llh, 1,
-						     &jra->jra_lcookie);
-			if (rc)
-				CERROR("%s: can't cancel record: %d\n",
-				       obd->obd_name, rc);
-		} else {
+		if (req->rq_import_generation != imp->imp_generation) {
 			DEBUG_REQ(D_OTHER, req, "imp_committed = %llu",
 				  imp->imp_peer_committed_transno);
+		} else if (cookies == NULL) {
+			osp_sync_cancel_batch(env, d, llh, &jra->jra_lcookie,
+					      1);
+		} else {
+			cookies[count++] = jra->jra_lcookie;
+			if (count == OSP_SYNC_CANCEL_BATCH) {
+				osp_sync_cancel_batch(env, d, llh, cookies,
+						      count);
+				count = 0;
+			}
 		}
 		ptlrpc_req_finished(req);
 		done++;
 	}
+	osp_sync_cancel_batch(env, d, llh, cookies, count);
 
 	llog_ctxt_put(ctxt);
 
@@ -1511,10 +1584,15 @@ int osp_sync_init(const struct lu_env *env, struct osp_device *d)
 	init_waitqueue_head(&d->opd_sync_thread.t_ctl_waitq);
 	INIT_LIST_HEAD(&d->opd_sync_in_flight_list);
 	INIT_LIST_HEAD(&d->opd_sync_committed_there);
+	d->opd_sync_drain_stamp = ktime_get();
 
 	if (d->opd_storage->dd_rdonly)
 		RETURN(0);
 
+	/* not fatal, the records are cancelled one by one without it */
+	OBD_ALLOC(d->opd_sync_cancel_cookies,
+		  OSP_SYNC_CANCEL_BATCH * sizeof(struct llog_cookie));
+
 	/*
 	 * initialize llog storing changes
 	 */
@@ -1544,6 +1622,11 @@ int osp_sync_init(const struct lu_env *env, struct osp_device *d)
 err_llog:
 	osp_sync_llog_fini(env, d);
 err_id:
+	if (d->opd_sync_cancel_cookies != NULL) {
+		OBD_FREE(d->opd_sync_cancel_cookies,
+			 OSP_SYNC_CANCEL_BATCH * sizeof(struct llog_cookie));
+		d->opd_sync_cancel_cookies = NULL;
+	}
 	return rc;
 }
 
@@ -1568,6 +1651,12 @@ int osp_sync_fini(struct osp_device *d)
 		wait_event(thread->t_ctl_waitq, thread_is_stopped(thread));
 	}
 
+	if (d->opd_sync_cancel_cookies != NULL) {
+		OBD_FREE(d->opd_sync_cancel_cookies,
+			 OSP_SYNC_CANCEL_BATCH * sizeof(struct llog_cookie));
+		d->opd_sync_cancel_cookies = NULL;
+	}
+
 	RETURN(0);
 }
 
@@ -3383,6 +3383,8 @@ EXPORT_SYMBOL(ptlrpc_sample_next_xid);
 struct ptlrpc_work_async_args {
 	int   (*cb)(const struct lu_env *, void *);
 	void   *cbdata;
+	/* CPT to run the work on, CFS_CPT_ANY for the CPT queueing it */
+	int	cpt;
 };
 
 static void ptlrpcd_add_work_req(struct ptlrpc_request *req)
@@ -3462,11 +3464,44 @@ void *ptlrpcd_alloc_work(struct obd_import *imp,
 	args = ptlrpc_req_async_args(req);
 	args->cb     = cb;
 	args->cbdata = cbdata;
+	args->cpt    = CFS_CPT_ANY;
 
 	RETURN(req);
 }
 EXPORT_SYMBOL(ptlrpcd_alloc_work);
 
+/**
+ * Make the work run by ptlrpcd threads of CPT \a cpt, whichever CPT it
+ * is queued from. Any RPCs the work sends are handled there as well.
+ * CFS_CPT_ANY restores the default of running it on the local CPT.
+ */
+void ptlrpcd_work_set_cpt(void *handler, int cpt)
+{
+	struct ptlrpc_request *req = handler;
+	struct ptlrpc_work_async_args *args = ptlrpc_req_async_args(req);
+
+	LASSERT(ptlrpcd_check_work(req));
+	LASSERT(cpt == CFS_CPT_ANY ||
+		(cpt >= 0 && cpt < cfs_cpt_number(cfs_cpt_table)));
+	args->cpt = cpt;
+}
+EXPORT_SYMBOL(ptlrpcd_work_set_cpt);
+
+/**
+ * CPT a ptlrpcd request should be handled on, CFS_CPT_ANY if it has no
+ * preference.
+ */
+int ptlrpcd_req_cpt(struct ptlrpc_request *req)
+{
+	struct ptlrpc_work_async_args *args;
+
+	if (!ptlrpcd_check_work(req))
+		return CFS_CPT_ANY;
+
+	args = ptlrpc_req_async_args(req);
+	return args->cpt;
+}
+
 void ptlrpcd_destroy_work(void *handler)
 {
         struct ptlrpc_request *req = handler;
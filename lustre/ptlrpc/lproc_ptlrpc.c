@@ -477,6 +477,62 @@ static ssize_t threads_max_store(struct kobject *kobj, struct attribute *attr,
 }
 LUSTRE_RW_ATTR(threads_max);
 
+static ssize_t threads_idle_timeout_show(struct kobject *kobj,
+					 struct attribute *attr, char *buf)
+{
+	struct ptlrpc_service *svc = container_of(kobj, struct ptlrpc_service,
+						  srv_kobj);
+
+	return sprintf(buf, "%d\n", svc->srv_thr_idle_timeout);
+}
+
+static ssize_t threads_idle_timeout_store(struct kobject *kobj,
+					  struct attribute *attr,
+					  const char *buffer, size_t count)
+{
+	struct ptlrpc_service *svc = container_of(kobj, struct ptlrpc_service,
+						  srv_kobj);
+	struct ptlrpc_service_part *svcpt;
+	unsigned int val;
+	int rc;
+	int i;
+
+	rc = kstrtouint(buffer, 10, &val);
+	if (rc < 0)
+		return rc;
+
+	if (val > INT_MAX)
+		return -ERANGE;
+
+	spin_lock(&svc->srv_lock);
+	svc->srv_thr_idle_timeout = val;
+	spin_unlock(&svc->srv_lock);
+
+	/* let the idle threads wait with the new timeout right away */
+	ptlrpc_service_for_each_part(svcpt, i, svc)
+		wake_up_all(&svcpt->scp_waitq);
+
+	return count;
+}
+LUSTRE_RW_ATTR(threads_idle_timeout);
+
+static ssize_t threads_retired_show(struct kobject *kobj,
+				    struct attribute *attr,
+				    char *buf)
+{
+	struct ptlrpc_service *svc = container_of(kobj, struct ptlrpc_service,
+						  srv_kobj);
+	struct ptlrpc_service_part *svcpt;
+	int total = 0;
+	int i;
+
+	ptlrpc_service_for_each_part(svcpt, i, svc)
+		total += svcpt->scp_nthrs_retired;
+
+	return sprintf(buf, "%d\n", total);
+}
+LUSTRE_RO_ATTR(threads_retired);
+
 /**
  * Translates \e ptlrpc_nrs_pol_state values to human-readable strings.
  *
@@ -1156,6 +1212,8 @@ static struct attribute *ptlrpc_svc_attrs[] = {
 	&lustre_attr_threads_min.attr,
 	&lustre_attr_threads_started.attr,
 	&lustre_attr_threads_max.attr,
+	&lustre_attr_threads_idle_timeout.attr,
+	&lustre_attr_threads_retired.attr,
 	&lustre_attr_high_priority_ratio.attr,
 	NULL,
 };
@@ -82,6 +82,8 @@ static enum hrtimer_restart nrs_tbf_timer_cb(struct hrtimer *timer)
 
 #define NRS_TBF_DEFAULT_RULE "default"
 
+static void nrs_tbf_rule_put(struct nrs_tbf_rule *rule);
+
 static void nrs_tbf_rule_fini(struct nrs_tbf_rule *rule)
 {
 	LASSERT(atomic_read(&rule->tr_ref) == 0);
@@ -89,6 +91,8 @@ static void nrs_tbf_rule_fini(struct nrs_tbf_rule *rule)
 	LASSERT(list_empty(&rule->tr_linkage));
 
 	rule->tr_head->th_ops->o_rule_fini(rule);
+	if (rule->tr_parent != NULL)
+		nrs_tbf_rule_put(rule->tr_parent);
 	OBD_FREE_PTR(rule);
 }
 
@@ -287,6 +291,7 @@ nrs_tbf_rule_start(struct ptlrpc_nrs_policy *policy,
 	struct nrs_tbf_rule	*tmp_rule;
 	struct nrs_tbf_rule	*next_rule;
 	char			*next_name = start->u.tc_start.ts_next_name;
+	char			*parent_name = start->u.tc_start.ts_parent_name;
 	int			 rc;
 
 	rule = nrs_tbf_rule_find(head, start->tc_name);
@@ -305,7 +310,10 @@ nrs_tbf_rule_start(struct ptlrpc_nrs_policy *policy,
 	rule->tr_nsecs = NSEC_PER_SEC;
 	do_div(rule->tr_nsecs, rule->tr_rpc_rate);
 	rule->tr_depth = tbf_depth;
+	rule->tr_ntoken = rule->tr_depth;
+	rule->tr_check_time = ktime_to_ns(ktime_get());
 	atomic_set(&rule->tr_ref, 1);
+	atomic_set(&rule->tr_nchildren, 0);
 	INIT_LIST_HEAD(&rule->tr_cli_list);
 	INIT_LIST_HEAD(&rule->tr_nids);
 	INIT_LIST_HEAD(&rule->tr_linkage);
@@ -328,9 +336,22 @@ nrs_tbf_rule_start(struct ptlrpc_nrs_policy *policy,
 		return -EEXIST;
 	}
 
+	if (parent_name) {
+		/* the reference is dropped in nrs_tbf_rule_fini() */
+		rule->tr_parent = nrs_tbf_rule_find_nolock(head, parent_name);
+		if (!rule->tr_parent) {
+			spin_unlock(&head->th_rule_lock);
+			nrs_tbf_rule_put(rule);
+			return -ENOENT;
+		}
+		atomic_inc(&rule->tr_parent->tr_nchildren);
+	}
+
 	if (next_name) {
 		next_rule = nrs_tbf_rule_find_nolock(head, next_name);
 		if (!next_rule) {
+			if (rule->tr_parent)
+				atomic_dec(&rule->tr_parent->tr_nchildren);
 			spin_unlock(&head->th_rule_lock);
 			nrs_tbf_rule_put(rule);
 			return -ENOENT;
@@ -350,8 +371,9 @@ nrs_tbf_rule_start(struct ptlrpc_nrs_policy *policy,
 		head->th_rule = rule;
 	}
 
-	CDEBUG(D_RPCTRACE, "TBF starts rule@%p rate %llu gen %llu\n",
-	       rule, rule->tr_rpc_rate, rule->tr_generation);
+	CDEBUG(D_RPCTRACE, "TBF starts rule@%p rate %llu gen %llu parent %s\n",
+	       rule, rule->tr_rpc_rate, rule->tr_generation,
+	       rule->tr_parent ? rule->tr_parent->tr_name : "none");
 
 	return 0;
 }
@@ -467,6 +489,14 @@ nrs_tbf_rule_stop(struct ptlrpc_nrs_policy *policy,
 	if (rule == NULL)
 		return -ENOENT;
 
+	/* children still charge their requests to this rule */
+	if (atomic_read(&rule->tr_nchildren) > 0) {
+		nrs_tbf_rule_put(rule);
+		return -EBUSY;
+	}
+
+	if (rule->tr_parent)
+		atomic_dec(&rule->tr_parent->tr_nchildren);
 	list_del_init(&rule->tr_linkage);
 	rule->tr_flags |= NTRS_STOPPING;
 	nrs_tbf_rule_put(rule);
@@ -3028,6 +3058,68 @@ static void nrs_tbf_res_put(struct ptlrpc_nrs_policy *policy,
 	head->th_ops->o_cli_put(head, cli);
 }
 
+/**
+ * The first rule whose aggregate bucket the requests of \a rule are charged
+ * to: the rule itself if it is a parent, otherwise its parent if any.
+ */
+static inline struct nrs_tbf_rule *
+nrs_tbf_rule_bucket(struct nrs_tbf_rule *rule)
+{
+	return atomic_read(&rule->tr_nchildren) > 0 ? rule : rule->tr_parent;
+}
+
+/**
+ * Returns the tokens available in the aggregate bucket of \a rule at \a now.
+ */
+static __u64 nrs_tbf_rule_ntoken(struct nrs_tbf_rule *rule, __u64 now)
+{
+	__u64 ntoken;
+
+	LASSERT(now >= rule->tr_check_time);
+	ntoken = (now - rule->tr_check_time) * rule->tr_rpc_rate;
+	do_div(ntoken, NSEC_PER_SEC);
+	ntoken += rule->tr_ntoken;
+
+	return min(ntoken, rule->tr_depth);
+}
+
+/**
+ * Checks the aggregate buckets of the ancestors of client \a cli.
+ *
+ * \retval 0 each ancestor bucket holds a token
+ * \retval the time at which the most constrained ancestor gets its next
+ *	   token otherwise
+ */
+static __u64 nrs_tbf_cli_ancestor_deadline(struct nrs_tbf_client *cli,
+					   __u64 now)
+{
+	struct nrs_tbf_rule *rule;
+	__u64 deadline = 0;
+
+	for (rule = nrs_tbf_rule_bucket(cli->tc_rule); rule != NULL;
+	     rule = rule->tr_parent) {
+		if (nrs_tbf_rule_ntoken(rule, now) == 0)
+			deadline = max(deadline,
+				       rule->tr_check_time + rule->tr_nsecs);
+	}
+
+	return deadline;
+}
+
+/**
+ * Takes a token from the aggregate bucket of each ancestor of \a cli.
+ */
+static void nrs_tbf_cli_ancestor_charge(struct nrs_tbf_client *cli, __u64 now)
+{
+	struct nrs_tbf_rule *rule;
+
+	for (rule = nrs_tbf_rule_bucket(cli->tc_rule); rule != NULL;
+	     rule = rule->tr_parent) {
+		rule->tr_ntoken = nrs_tbf_rule_ntoken(rule, now) - 1;
+		rule->tr_check_time = now;
+	}
+}
+
 /**
  * Called when getting a request from the TBF policy for handling, or just
  * peeking; removes the request from the policy when it is to be handled.
@@ -3059,6 +3151,7 @@ struct ptlrpc_nrs_request *nrs_tbf_req_get(struct ptlrpc_nrs_policy *policy,
 	if (!peek && policy->pol_nrs->nrs_throttling)
 		return NULL;
 
+again:
 	node = cfs_binheap_root(head->th_binheap);
 	if (unlikely(node == NULL))
 		return NULL;
@@ -3075,6 +3168,7 @@ struct ptlrpc_nrs_request *nrs_tbf_req_get(struct ptlrpc_nrs_policy *policy,
 		__u64 passed;
 		__u64 ntoken;
 		__u64 deadline;
+		__u64 parent_deadline;
 		__u64 old_resid = 0;
 
 		deadline = cli->tc_check_time +
@@ -3096,7 +3190,25 @@ struct ptlrpc_nrs_request *nrs_tbf_req_get(struct ptlrpc_nrs_policy *policy,
 		} else if (ntoken > cli->tc_depth)
 			ntoken = cli->tc_depth;
 
-		if (ntoken > 0) {
+		parent_deadline = nrs_tbf_cli_ancestor_deadline(cli, now);
+		if (ntoken > 0 && parent_deadline != 0) {
+			/* Throttled by an ancestor rule. Requeue the class at
+			 * the deadline of the most constrained ancestor, so
+			 * that other classes can run in the meantime. */
+			if (rule->tr_flags & NTRS_REALTIME)
+				cli->tc_nsecs_resid = old_resid;
+			cli->tc_deadline = parent_deadline;
+			cfs_binheap_relocate(head->th_binheap, &cli->tc_node);
+			if (node != cfs_binheap_root(head->th_binheap))
+				goto again;
+
+			policy->pol_nrs->nrs_throttling = 1;
+			head->th_deadline = parent_deadline;
+			hrtimer_start(&head->th_timer,
+				      ktime_add_ns(ktime_set(0, 0),
+						   parent_deadline),
+				      HRTIMER_MODE_ABS);
+		} else if (ntoken > 0) {
 			struct ptlrpc_request *req;
 			nrq = list_entry(cli->tc_list.next,
 					     struct ptlrpc_nrs_request,
@@ -3107,6 +3219,7 @@ struct ptlrpc_nrs_request *nrs_tbf_req_get(struct ptlrpc_nrs_policy *policy,
 			ntoken--;
 			cli->tc_ntoken = ntoken;
 			cli->tc_check_time = now;
+			nrs_tbf_cli_ancestor_charge(cli, now);
 			list_del_init(&nrq->nr_u.tbf.tr_list);
 			if (list_empty(&cli->tc_list)) {
 				cfs_binheap_remove(head->th_binheap,
@@ -3437,6 +3550,12 @@ nrs_tbf_parse_value_pair(struct nrs_tbf_cmd *cmd, char *buffer)
 			cmd->u.tc_change.tc_next_name = val;
 		else
 			return -EINVAL;
+	} else if (strcmp(key, "parent") == 0) {
+		if (!name_is_valid(val) ||
+		    cmd->tc_cmd != NRS_CTL_TBF_START_RULE)
+			return -EINVAL;
+
+		cmd->u.tc_start.ts_parent_name = val;
 	} else if (strcmp(key, "realtime") == 0) {
 		unsigned long realtime;
 
@@ -64,6 +64,8 @@ extern struct mutex ptlrpcd_mutex;
 extern struct mutex pinger_mutex;
 
 int ptlrpc_start_thread(struct ptlrpc_service_part *svcpt, int wait);
+int ptlrpc_rqbd_pool_init(void);
+void ptlrpc_rqbd_pool_fini(void);
 /* ptlrpcd.c */
 int ptlrpcd_start(struct ptlrpcd_ctl *pc);
 
@@ -89,6 +91,7 @@ void ptlrpc_set_bulk_mbits(struct ptlrpc_request *req);
 void ptlrpc_assign_next_xid_nolock(struct ptlrpc_request *req);
 __u64 ptlrpc_known_replied_xid(struct obd_import *imp);
 void ptlrpc_add_unreplied(struct ptlrpc_request *req);
+int ptlrpcd_req_cpt(struct ptlrpc_request *req);
 
 /* events.c */
 int ptlrpc_init_portals(void);
@@ -73,10 +73,14 @@ static __init int ptlrpc_init(void)
 	if (rc)
 		GOTO(err_tgt, rc);
 
-	rc = ptlrpc_request_cache_init();
+	rc = ptlrpc_rqbd_pool_init();
 	if (rc)
 		GOTO(err_hr, rc);
 
+	rc = ptlrpc_request_cache_init();
+	if (rc)
+		GOTO(err_rqbd, rc);
+
 	rc = ptlrpc_init_portals();
 	if (rc)
 		GOTO(err_cache, rc);
@@ -122,6 +126,8 @@ err_portals:
 	ptlrpc_exit_portals();
 err_cache:
 	ptlrpc_request_cache_fini();
+err_rqbd:
+	ptlrpc_rqbd_pool_fini();
 err_hr:
 	ptlrpc_hr_fini();
 err_tgt:
@@ -140,6 +146,7 @@ static void __exit ptlrpc_exit(void)
 	ptlrpc_stop_pinger();
 	ptlrpc_exit_portals();
 	ptlrpc_request_cache_fini();
+	ptlrpc_rqbd_pool_fini();
 	ptlrpc_hr_fini();
 	ptlrpc_connection_fini();
 	tgt_mod_exit();
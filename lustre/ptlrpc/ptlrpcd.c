@@ -175,7 +175,9 @@ ptlrpcd_select_pc(struct ptlrpc_request *req)
 	if (req != NULL && req->rq_send_state != LUSTRE_IMP_FULL)
 		return &ptlrpcd_rcv;
 
-	cpt = cfs_cpt_current(cfs_cpt_table, 1);
+	cpt = req != NULL ? ptlrpcd_req_cpt(req) : CFS_CPT_ANY;
+	if (cpt == CFS_CPT_ANY)
+		cpt = cfs_cpt_current(cfs_cpt_table, 1);
 	if (ptlrpcds_cpt_idx == NULL)
 		idx = cpt;
 	else
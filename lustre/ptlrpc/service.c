@@ -66,12 +66,32 @@ struct list_head ptlrpc_all_services;
 /** Used to protect the \e ptlrpc_all_services list */
 struct mutex ptlrpc_all_services_mutex;
 
+/** # spare request buffers of all services */
+static atomic_t ptlrpc_rqbd_nspare = ATOMIC_INIT(0);
+static struct shrinker *ptlrpc_rqbd_shrinker;
+
 static struct ptlrpc_request_buffer_desc *
 ptlrpc_alloc_rqbd(struct ptlrpc_service_part *svcpt)
 {
 	struct ptlrpc_service		  *svc = svcpt->scp_service;
 	struct ptlrpc_request_buffer_desc *rqbd;
 
+	/* reuse a spare buffer before hitting the allocator */
+	spin_lock(&svcpt->scp_lock);
+	if (!list_empty(&svcpt->scp_rqbd_spare)) {
+		rqbd = list_entry(svcpt->scp_rqbd_spare.next,
+				  struct ptlrpc_request_buffer_desc,
+				  rqbd_list);
+		list_move(&rqbd->rqbd_list, &svcpt->scp_rqbd_idle);
+		svcpt->scp_nrqbds_spare--;
+		svcpt->scp_nrqbds_total++;
+		spin_unlock(&svcpt->scp_lock);
+
+		atomic_dec(&ptlrpc_rqbd_nspare);
+		return rqbd;
+	}
+	spin_unlock(&svcpt->scp_lock);
+
 	OBD_CPT_ALLOC_PTR(rqbd, svc->srv_cptable, svcpt->scp_cpt);
 	if (rqbd == NULL)
 		return NULL;
@@ -113,6 +133,141 @@ ptlrpc_free_rqbd(struct ptlrpc_request_buffer_desc *rqbd)
 	OBD_FREE_PTR(rqbd);
 }
 
+/**
+ * Whether a request buffer no longer needed for posting should be kept
+ * on the spare list, called with ptlrpc_service_part::scp_lock held.
+ * At most srv_nbuf_per_group buffers are kept per partition and spare
+ * buffers count against req_buffers_max.
+ */
+static inline bool
+ptlrpc_rqbd_keep_spare(struct ptlrpc_service_part *svcpt)
+{
+	struct ptlrpc_service *svc = svcpt->scp_service;
+
+	if (test_req_buffer_pressure || svc->srv_is_stopping)
+		return false;
+
+	if (svcpt->scp_nrqbds_spare >= svc->srv_nbuf_per_group)
+		return false;
+
+	return svc->srv_nrqbds_max == 0 ||
+	       svcpt->scp_nrqbds_total + svcpt->scp_nrqbds_spare <
+	       svc->srv_nrqbds_max;
+}
+
+/**
+ * Release up to \a nr spare request buffers of \a svcpt, oldest first.
+ *
+ * \retval number of buffers released
+ */
+static int
+ptlrpc_free_spare_rqbds(struct ptlrpc_service_part *svcpt, int nr)
+{
+	struct ptlrpc_request_buffer_desc *rqbd;
+	struct list_head zombie;
+	int count = 0;
+
+	INIT_LIST_HEAD(&zombie);
+	spin_lock(&svcpt->scp_lock);
+	while (count < nr && !list_empty(&svcpt->scp_rqbd_spare)) {
+		rqbd = list_entry(svcpt->scp_rqbd_spare.prev,
+				  struct ptlrpc_request_buffer_desc,
+				  rqbd_list);
+		list_move(&rqbd->rqbd_list, &zombie);
+		svcpt->scp_nrqbds_spare--;
+		count++;
+	}
+	spin_unlock(&svcpt->scp_lock);
+
+	if (count == 0)
+		return 0;
+
+	atomic_sub(count, &ptlrpc_rqbd_nspare);
+	while (!list_empty(&zombie)) {
+		rqbd = list_entry(zombie.next,
+				  struct ptlrpc_request_buffer_desc,
+				  rqbd_list);
+		list_del(&rqbd->rqbd_list);
+		OBD_FREE_LARGE(rqbd->rqbd_buffer,
+			       svcpt->scp_service->srv_buf_size);
+		OBD_FREE_PTR(rqbd);
+	}
+
+	return count;
+}
+
+static unsigned long ptlrpc_rqbd_shrink_count(struct shrinker *s,
+					      struct shrink_control *sc)
+{
+	return atomic_read(&ptlrpc_rqbd_nspare);
+}
+
+static unsigned long ptlrpc_rqbd_shrink_scan(struct shrinker *s,
+					     struct shrink_control *sc)
+{
+	struct ptlrpc_service *svc;
+	struct ptlrpc_service_part *svcpt;
+	unsigned long freed = 0;
+	int i;
+
+	/* services are registered and unregistered under this mutex */
+	if (!mutex_trylock(&ptlrpc_all_services_mutex))
+		return SHRINK_STOP;
+
+	list_for_each_entry(svc, &ptlrpc_all_services, srv_list) {
+		ptlrpc_service_for_each_part(svcpt, i, svc) {
+			if (freed >= sc->nr_to_scan)
+				goto out;
+			freed += ptlrpc_free_spare_rqbds(svcpt,
+						sc->nr_to_scan - freed);
+		}
+	}
+out:
+	mutex_unlock(&ptlrpc_all_services_mutex);
+
+	CDEBUG(D_RPCTRACE, "released %lu spare request buffers\n", freed);
+	return freed;
+}
+
+#ifndef HAVE_SHRINKER_COUNT
+static int ptlrpc_rqbd_shrink(SHRINKER_ARGS(sc, nr_to_scan, gfp_mask))
+{
+	struct shrink_control scv = {
+		.nr_to_scan = shrink_param(sc, nr_to_scan),
+		.gfp_mask   = shrink_param(sc, gfp_mask)
+	};
+#if !defined(HAVE_SHRINKER_WANT_SHRINK_PTR) && !defined(HAVE_SHRINK_CONTROL)
+	struct shrinker *shrinker = NULL;
+#endif
+
+	if (scv.nr_to_scan != 0)
+		ptlrpc_rqbd_shrink_scan(shrinker, &scv);
+
+	return ptlrpc_rqbd_shrink_count(shrinker, &scv);
+}
+#endif /* HAVE_SHRINKER_COUNT */
+
+int ptlrpc_rqbd_pool_init(void)
+{
+	DEF_SHRINKER_VAR(shvar, ptlrpc_rqbd_shrink,
+			 ptlrpc_rqbd_shrink_count, ptlrpc_rqbd_shrink_scan);
+
+	ptlrpc_rqbd_shrinker = set_shrinker(DEFAULT_SEEKS, &shvar);
+	if (ptlrpc_rqbd_shrinker == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+void ptlrpc_rqbd_pool_fini(void)
+{
+	if (ptlrpc_rqbd_shrinker != NULL) {
+		remove_shrinker(ptlrpc_rqbd_shrinker);
+		ptlrpc_rqbd_shrinker = NULL;
+	}
+	LASSERT(atomic_read(&ptlrpc_rqbd_nspare) == 0);
+}
+
 static int
 ptlrpc_grow_req_bufs(struct ptlrpc_service_part *svcpt, int post)
 {
@@ -607,6 +762,7 @@ ptlrpc_service_part_init(struct ptlrpc_service *svc,
 	spin_lock_init(&svcpt->scp_lock);
 	mutex_init(&svcpt->scp_mutex);
 	INIT_LIST_HEAD(&svcpt->scp_rqbd_idle);
+	INIT_LIST_HEAD(&svcpt->scp_rqbd_spare);
 	INIT_LIST_HEAD(&svcpt->scp_rqbd_posted);
 	INIT_LIST_HEAD(&svcpt->scp_req_incoming);
 	init_waitqueue_head(&svcpt->scp_waitq);
@@ -788,6 +944,7 @@ ptlrpc_register_service(struct ptlrpc_service_conf *conf,
 	service->srv_thread_name	= conf->psc_thr.tc_thr_name;
 	service->srv_ctx_tags		= conf->psc_thr.tc_ctx_tags;
 	service->srv_hpreq_ratio	= PTLRPC_SVC_HP_RATIO;
+	service->srv_thr_idle_timeout	= PTLRPC_THR_IDLE_TIMEOUT;
 	service->srv_ops		= conf->psc_ops;
 
 	for (i = 0; i < ncpts; i++) {
@@ -966,9 +1123,18 @@ void ptlrpc_server_drop_request(struct ptlrpc_request *req)
 			    test_req_buffer_pressure) {
 				/* like in ptlrpc_free_rqbd() */
 				svcpt->scp_nrqbds_total--;
-				OBD_FREE_LARGE(rqbd->rqbd_buffer,
-					       svc->srv_buf_size);
-				OBD_FREE_PTR(rqbd);
+				if (ptlrpc_rqbd_keep_spare(svcpt)) {
+					/* keep it for the next time the
+					 * pool has to grow */
+					list_add(&rqbd->rqbd_list,
+						 &svcpt->scp_rqbd_spare);
+					svcpt->scp_nrqbds_spare++;
+					atomic_inc(&ptlrpc_rqbd_nspare);
+				} else {
+					OBD_FREE_LARGE(rqbd->rqbd_buffer,
+						       svc->srv_buf_size);
+					OBD_FREE_PTR(rqbd);
+				}
 			} else {
 				list_add_tail(&rqbd->rqbd_list,
 					      &svcpt->scp_rqbd_idle);
@@ -2457,6 +2623,49 @@ ptlrpc_server_request_incoming(struct ptlrpc_service_part *svcpt)
 	return !list_empty(&svcpt->scp_req_incoming);
 }
 
+/**
+ * threads beyond the initial count which may be retired, the caller
+ * should hold ptlrpc_service_part::scp_lock to get reliable result
+ */
+static inline int
+ptlrpc_threads_shrinkable(struct ptlrpc_service_part *svcpt)
+{
+	return svcpt->scp_service->srv_thr_idle_timeout > 0 &&
+	       svcpt->scp_nthrs_running - svcpt->scp_nthrs_stopping >
+	       svcpt->scp_service->srv_nthrs_cpt_init;
+}
+
+/**
+ * Decide whether \a thread, which has just been idle for a whole
+ * srv_thr_idle_timeout, should exit.
+ *
+ * Threads are only retired while the partition runs more threads than
+ * srv_nthrs_cpt_init, nothing is waiting to be handled and no thread has
+ * been started within the last idle period, so that a burst of requests
+ * followed by a short pause doesn't make the pool grow and shrink over
+ * and over again.
+ */
+static bool ptlrpc_thread_retire(struct ptlrpc_service_part *svcpt,
+				 struct ptlrpc_thread *thread)
+{
+	int idle = svcpt->scp_service->srv_thr_idle_timeout;
+	bool retire = false;
+
+	spin_lock(&svcpt->scp_lock);
+	if (!thread_is_stopping(thread) &&
+	    ptlrpc_threads_shrinkable(svcpt) &&
+	    svcpt->scp_nthrs_starting == 0 &&
+	    !ptlrpc_server_request_incoming(svcpt) &&
+	    !ptlrpc_server_request_pending(svcpt, false) &&
+	    ktime_get_seconds() - svcpt->scp_thr_grow_time >= idle) {
+		svcpt->scp_nthrs_stopping++;
+		retire = true;
+	}
+	spin_unlock(&svcpt->scp_lock);
+
+	return retire;
+}
+
 static __attribute__((__noinline__)) int
 ptlrpc_wait_event(struct ptlrpc_service_part *svcpt,
 		  struct ptlrpc_thread *thread)
@@ -2464,13 +2673,25 @@ ptlrpc_wait_event(struct ptlrpc_service_part *svcpt,
 	/* Don't exit while there are replies to be handled */
 	struct l_wait_info lwi = LWI_TIMEOUT(svcpt->scp_rqbd_timeout,
 					     ptlrpc_retry_rqbds, svcpt);
+	bool idle_wait = false;
+	int idle = 0;
+	int rc;
 
 	lc_watchdog_disable(thread->t_watchdog);
 
 	cond_resched();
 
-	l_wait_event_exclusive_head(svcpt->scp_waitq,
+	if (svcpt->scp_rqbd_timeout == 0 && ptlrpc_threads_shrinkable(svcpt)) {
+		idle = svcpt->scp_service->srv_thr_idle_timeout;
+		lwi = LWI_TIMEOUT(cfs_time_seconds(idle), NULL, NULL);
+		idle_wait = true;
+	}
+
+	/* a new idle timeout wakes the thread up to wait with it instead */
+	rc = l_wait_event_exclusive_head(svcpt->scp_waitq,
 				ptlrpc_thread_stopping(thread) ||
+				(idle_wait && idle !=
+				 svcpt->scp_service->srv_thr_idle_timeout) ||
 				ptlrpc_server_request_incoming(svcpt) ||
 				ptlrpc_server_request_pending(svcpt, false) ||
 				ptlrpc_rqbd_pending(svcpt) ||
@@ -2479,6 +2700,10 @@ ptlrpc_wait_event(struct ptlrpc_service_part *svcpt,
 	if (ptlrpc_thread_stopping(thread))
 		return -EINTR;
 
+	if (idle_wait && rc == -ETIMEDOUT &&
+	    ptlrpc_thread_retire(svcpt, thread))
+		return -ETIMEDOUT;
+
 	lc_watchdog_touch(thread->t_watchdog,
 			  ptlrpc_server_get_timeout(svcpt));
 	return 0;
@@ -2498,6 +2723,7 @@ static int ptlrpc_main(void *arg)
 	struct ptlrpc_reply_state	*rs;
 	struct group_info *ginfo = NULL;
 	struct lu_env *env;
+	bool retired = false;
 	int counter = 0, rc = 0;
 	ENTRY;
 
@@ -2571,6 +2797,7 @@ static int ptlrpc_main(void *arg)
 	 * we are now running, however we will exit as soon as possible */
 	thread_add_flags(thread, SVC_RUNNING);
 	svcpt->scp_nthrs_running++;
+	svcpt->scp_thr_grow_time = ktime_get_seconds();
 	spin_unlock(&svcpt->scp_lock);
 
 	/* wake up our creator in case he's still waiting. */
@@ -2589,8 +2816,12 @@ static int ptlrpc_main(void *arg)
 
 	/* XXX maintain a list of all managed devices: insert here */
 	while (!ptlrpc_thread_stopping(thread)) {
-		if (ptlrpc_wait_event(svcpt, thread))
+		int wait_rc = ptlrpc_wait_event(svcpt, thread);
+
+		if (wait_rc != 0) {
+			retired = wait_rc == -ETIMEDOUT;
 			break;
+		}
 
 		ptlrpc_check_rqbd_pool(svcpt);
 
@@ -2664,6 +2895,22 @@ out:
 		svcpt->scp_nthrs_running--;
 	}
 
+	if (retired) {
+		CDEBUG(D_RPCTRACE, "%s: retired idle thread %s\n",
+		       svc->srv_name, thread->t_name);
+		svcpt->scp_nthrs_stopping--;
+		svcpt->scp_nthrs_retired++;
+		if (!thread_is_stopping(thread)) {
+			/* nobody else knows about this thread any more,
+			 * otherwise it is released by
+			 * ptlrpc_svcpt_stop_threads() as usual */
+			list_del(&thread->t_link);
+			spin_unlock(&svcpt->scp_lock);
+			OBD_FREE_PTR(thread);
+			return rc;
+		}
+	}
+
 	thread->t_id = rc;
 	thread_add_flags(thread, SVC_STOPPED);
 
@@ -3248,6 +3495,7 @@ ptlrpc_service_purge_all(struct ptlrpc_service *svc)
 					      rqbd_list);
 			ptlrpc_free_rqbd(rqbd);
 		}
+		ptlrpc_free_spare_rqbds(svcpt, INT_MAX);
 		ptlrpc_wait_replies(svcpt);
 
 		while (!list_empty(&svcpt->scp_rep_idle)) {
@@ -73,9 +73,8 @@ static int tgt_bitmap_chunk_alloc(struct lu_target *lut, int chunk)
 /* Look for an available reply data slot in the bitmap
  * of the target @lut
  * Allocate bitmap chunk when first used
- * XXX algo could be improved if this routine limits performance
  */
-static int tgt_find_free_reply_slot(struct lu_target *lut)
+static int tgt_scan_reply_slot(struct lu_target *lut)
 {
 	unsigned long *bmp;
 	int chunk = 0;
@@ -106,6 +105,38 @@ static int tgt_find_free_reply_slot(struct lu_target *lut)
 	return -ENOSPC;
 }
 
+/* Get an available reply data slot of the target @lut
+ * Take a slot freed recently on the local CPT if there is one, this avoids
+ * the bitmap scan and keeps the reply data writes on recently used blocks,
+ * otherwise scan the bitmap
+ */
+static int tgt_find_free_reply_slot(struct lu_target *lut)
+{
+	struct tgt_reply_slot_cache *rsc;
+	ktime_t start = ktime_get();
+	int idx = -1;
+
+	if (lut->lut_reply_slot_cache != NULL) {
+		rsc = lut->lut_reply_slot_cache[cfs_cpt_current(cfs_cpt_table,
+								0)];
+		spin_lock(&rsc->rsc_lock);
+		if (rsc->rsc_count > 0)
+			idx = rsc->rsc_slots[--rsc->rsc_count];
+		spin_unlock(&rsc->rsc_lock);
+	}
+
+	if (idx >= 0)
+		atomic64_inc(&lut->lut_reply_slot_cached);
+	else
+		idx = tgt_scan_reply_slot(lut);
+
+	atomic64_inc(&lut->lut_reply_slot_allocs);
+	atomic64_add(ktime_to_ns(ktime_sub(ktime_get(), start)),
+		     &lut->lut_reply_slot_ns);
+
+	return idx;
+}
+
 /* Mark the reply data slot @idx 'used' in the corresponding bitmap chunk
  * of the target @lut
  * Allocate the bitmap chunk if necessary
@@ -145,6 +176,7 @@ static int tgt_set_reply_slot(struct lu_target *lut, int idx)
  */
 static int tgt_clear_reply_slot(struct lu_target *lut, int idx)
 {
+	struct tgt_reply_slot_cache *rsc;
 	int chunk;
 	int b;
 
@@ -167,6 +199,25 @@ static int tgt_clear_reply_slot(struct lu_target *lut, int idx)
 		return -ENOENT;
 	}
 
+	if (!test_bit(b, lut->lut_reply_bitmap[chunk])) {
+		CERROR("%s: slot %d already clear in bitmap\n",
+		       tgt_name(lut), idx);
+		return -EALREADY;
+	}
+
+	/* keep the slot 'used' in the local cache for the next reply */
+	if (lut->lut_reply_slot_cache != NULL) {
+		rsc = lut->lut_reply_slot_cache[cfs_cpt_current(cfs_cpt_table,
+								0)];
+		spin_lock(&rsc->rsc_lock);
+		if (rsc->rsc_count < LUT_REPLY_SLOT_CACHE_SIZE) {
+			rsc->rsc_slots[rsc->rsc_count++] = idx;
+			spin_unlock(&rsc->rsc_lock);
+			return 0;
+		}
+		spin_unlock(&rsc->rsc_lock);
+	}
+
 	if (test_and_clear_bit(b, lut->lut_reply_bitmap[chunk]) == 0) {
 		CERROR("%s: slot %d already clear in bitmap\n",
 		       tgt_name(lut), idx);
@@ -234,6 +234,34 @@ ssize_t tgt_fmd_seconds_store(struct kobject *kobj, struct attribute *attr,
 }
 LUSTRE_RW_ATTR(tgt_fmd_seconds);
 
+/**
+ * Show reply data slot allocation statistics.
+ *
+ * Number of slots allocated, how many of them came from the per-CPT
+ * caches of freed slots, and the average allocation time.
+ *
+ * \param[in] kobj	kobject
+ * \param[in] attr	attribute to show
+ * \param[in] buf	buffer to write to
+ *
+ * \retval		number of bytes written to \a buf
+ */
+static ssize_t reply_slot_stats_show(struct kobject *kobj,
+				     struct attribute *attr, char *buf)
+{
+	struct obd_device *obd = container_of(kobj, struct obd_device,
+					      obd_kset.kobj);
+	struct lu_target *lut = obd->u.obt.obt_lut;
+	s64 allocs = atomic64_read(&lut->lut_reply_slot_allocs);
+
+	return sprintf(buf, "allocs: %lld\ncached: %lld\navg_ns: %lld\n",
+		       allocs, (s64)atomic64_read(&lut->lut_reply_slot_cached),
+		       allocs ? div64_s64(atomic64_read(
+						&lut->lut_reply_slot_ns),
+					  allocs) : 0);
+}
+LUSTRE_RO_ATTR(reply_slot_stats);
+
 /* These two aliases are old names and kept for compatibility, they were
  * changed to 'tgt_fmd_count' and 'tgt_fmd_seconds'.
  * This change was made in Lustre 2.13, so these aliases can be removed
@@ -248,6 +276,7 @@ static const struct attribute *tgt_attrs[] = {
 	&lustre_attr_sync_lock_cancel.attr,
 	&lustre_attr_tgt_fmd_count.attr,
 	&lustre_attr_tgt_fmd_seconds.attr,
+	&lustre_attr_reply_slot_stats.attr,
 	&tgt_fmd_count_compat.attr,
 	&tgt_fmd_seconds_compat.attr,
 	NULL,
@@ -391,6 +420,7 @@ int tgt_init(const struct lu_env *env, struct lu_target *lut,
 	struct dt_object	*o;
 	struct tg_grants_data	*tgd = &lut->lut_tgd;
 	struct obd_statfs	*osfs;
+	struct tgt_reply_slot_cache *rsc;
 	int i, rc = 0;
 
 	ENTRY;
@@ -405,6 +435,10 @@ int tgt_init(const struct lu_env *env, struct lu_target *lut,
 	atomic_set(&lut->lut_client_generation, 0);
 	lut->lut_reply_data = NULL;
 	lut->lut_reply_bitmap = NULL;
+	lut->lut_reply_slot_cache = NULL;
+	atomic64_set(&lut->lut_reply_slot_allocs, 0);
+	atomic64_set(&lut->lut_reply_slot_cached, 0);
+	atomic64_set(&lut->lut_reply_slot_ns, 0);
 	obd->u.obt.obt_lut = lut;
 	obd->u.obt.obt_magic = OBT_MAGIC;
 
@@ -510,6 +544,13 @@ int tgt_init(const struct lu_env *env, struct lu_target *lut,
 	if (lut->lut_reply_bitmap == NULL)
 		GOTO(out, rc = -ENOMEM);
 
+	lut->lut_reply_slot_cache = cfs_percpt_alloc(cfs_cpt_table,
+					sizeof(struct tgt_reply_slot_cache));
+	if (lut->lut_reply_slot_cache == NULL)
+		GOTO(out, rc = -ENOMEM);
+	cfs_percpt_for_each(rsc, i, lut->lut_reply_slot_cache)
+		spin_lock_init(&rsc->rsc_lock);
+
 	memset(&attr, 0, sizeof(attr));
 	attr.la_valid = LA_MODE;
 	attr.la_mode = S_IFREG | S_IRUGO | S_IWUSR;
@@ -547,6 +588,9 @@ out_put:
 	if (lut->lut_reply_data != NULL)
 		dt_object_put(env, lut->lut_reply_data);
 	lut->lut_reply_data = NULL;
+	if (lut->lut_reply_slot_cache != NULL)
+		cfs_percpt_free(lut->lut_reply_slot_cache);
+	lut->lut_reply_slot_cache = NULL;
 	if (lut->lut_reply_bitmap != NULL) {
 		for (i = 0; i < LUT_REPLY_SLOTS_MAX_CHUNKS; i++) {
 			if (lut->lut_reply_bitmap[i] != NULL)
@@ -586,6 +630,9 @@ void tgt_fini(const struct lu_env *env, struct lu_target *lut)
 	if (lut->lut_reply_data != NULL)
 		dt_object_put(env, lut->lut_reply_data);
 	lut->lut_reply_data = NULL;
+	if (lut->lut_reply_slot_cache != NULL)
+		cfs_percpt_free(lut->lut_reply_slot_cache);
+	lut->lut_reply_slot_cache = NULL;
 	if (lut->lut_reply_bitmap != NULL) {
 		for (i = 0; i < LUT_REPLY_SLOTS_MAX_CHUNKS; i++) {
 			if (lut->lut_reply_bitmap[i] != NULL)
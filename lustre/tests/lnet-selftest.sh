@@ -184,6 +184,60 @@ test_smoke () {
 }
 run_test smoke "lst regression test"
 
+# small bulk reads with many RPCs in flight keep thousands of reply and bulk
+# MEs posted, so the rate is bound by LNet matching rather than bandwidth
+lst_match_CONCR=${lst_match_CONCR:-64}
+lst_match_DURATION=${lst_match_DURATION:-60}
+
+test_match_rate_sub () {
+	local servers=$1
+	local clients=$2
+	local nc=$(echo ${clients//,/ } | wc -w)
+	local ns=$(echo ${servers//,/ } | wc -w)
+
+	echo '#!/bin/bash'
+	echo 'set -e'
+	echo "$LST new_session --timeo 100000 match"
+	echo "$LST add_group c $(nids_list $clients)"
+	echo "$LST add_group s $(nids_list $servers)"
+	echo "$LST add_batch b"
+	echo "$LST add_test --batch b --concurrency $lst_match_CONCR" \
+	     "--distribute ${nc}:${ns} --from c --to s brw read size=4k"
+	echo "$LST run b"
+	echo "sleep 5"
+	echo "$LST stat --delay $lst_match_DURATION --count 1 s"
+	echo "$LST stop b"
+}
+
+test_match_rate () {
+	lst_prepare
+
+	local runlst=$TMP/match_rate.sh
+	local log=$TMP/$tfile.log
+	local ncpus
+	local rate
+	local rc
+
+	test_match_rate_sub $lst_SERVERS $lst_CLIENTS > $runlst
+	cat $runlst
+
+	run_lst $runlst | tee $log
+	rc=${PIPESTATUS[0]}
+	[ $rc = 0 ] || { _restore_mount; error "$runlst failed: $rc"; }
+
+	lst_end_session --verbose | tee -a $log
+
+	# messages per second seen by the servers, and per server core
+	rate=$(awk '/^\[LNet Rates of s\]/ { getline; print $3; exit }' $log)
+	ncpus=$(do_facet ost1 nproc)
+	[ -n "$rate" ] && echo "LNet rate: $rate msg/s," \
+		"$((${rate%.*} / ncpus)) msg/s per server core"
+
+	check_lst_err $log
+	lst_cleanup_all
+}
+run_test match_rate "lst small message rate benchmark"
+
 complete $SECONDS
 _restore_mount
 check_and_cleanup_lustre
@@ -4871,6 +4871,49 @@ test_132a() {
 }
 run_test 132a "PFL new component instantiate replay"
 
+test_133() {
+	local param=/sys/module/ptlrpc/parameters/tgt_lock_replay_threads
+	local mdtname="mdt.$FSNAME-MDT0000"
+	local threads
+	local locks
+	local old
+
+	do_facet $SINGLEMDS "test -f $param" ||
+		skip "no parallel lock replay support"
+
+	old=$(do_facet $SINGLEMDS "cat $param")
+	stack_trap "do_facet $SINGLEMDS 'echo $old > $param'" EXIT
+	do_facet $SINGLEMDS "echo 4 > $param"
+
+	mkdir -p $DIR/$tdir || error "mkdir $DIR/$tdir failed"
+	createmany -o $DIR/$tdir/$tfile- 200 ||
+		error "createmany failed"
+	ls -l $DIR/$tdir > /dev/null || error "ls $DIR/$tdir failed"
+
+	replay_barrier $SINGLEMDS
+	fail $SINGLEMDS
+
+	do_facet $SINGLEMDS "$LCTL get_param -n $mdtname.recovery_status"
+	locks=$(do_facet $SINGLEMDS \
+		"$LCTL get_param -n $mdtname.recovery_status" |
+		awk '/replayed_locks:/ { print $2 }')
+	[ -n "$locks" ] && [ $locks -gt 0 ] ||
+		error "no locks replayed: '$locks'"
+	do_facet $SINGLEMDS "$LCTL get_param -n $mdtname.recovery_status" |
+		grep -q lock_replay_time_ms ||
+		error "no lock replay time in recovery_status"
+	# locks of different resources are spread over the threads
+	threads=$(do_facet $SINGLEMDS \
+		"$LCTL get_param -n $mdtname.recovery_status" |
+		awk '/lock_replay_threads:/ { print $2 }')
+	[ -n "$threads" ] && [ $threads -gt 1 ] ||
+		error "locks replayed by $threads threads, expected > 1"
+
+	ls -l $DIR/$tdir > /dev/null || error "ls after failover failed"
+	unlinkmany $DIR/$tdir/$tfile- 200 || error "unlinkmany failed"
+}
+run_test 133 "parallel lock replay"
+
 complete $SECONDS
 check_and_cleanup_lustre
 exit_status
@@ -126,6 +126,31 @@ test_5() {
 }
 run_test 5 "add a network using an interface in the non-default namespace"
 
+test_6() {
+	local param=/sys/module/ksocklnd/parameters/conns_per_peer
+
+	[[ "$LNETLND" == "socklnd/ksocklnd" ]] || skip "need socklnd"
+
+	cleanup_lnet || exit 1
+	load_lnet
+	[[ -f $param ]] || skip "no conns_per_peer tunable"
+
+	echo 4 > $param || error "cannot set conns_per_peer to 4"
+	[[ $(cat $param) == 4 ]] || error "conns_per_peer $(cat $param) != 4"
+
+	# out of range values must be refused and leave the old value
+	for val in 0 -1 17 1000; do
+		echo $val > $param 2>/dev/null &&
+			error "conns_per_peer accepted $val"
+		[[ $(cat $param) == 4 ]] ||
+			error "conns_per_peer changed to $(cat $param) by $val"
+	done
+
+	echo 1 > $param || error "cannot reset conns_per_peer"
+	$LNETCTL lnet configure || error "lnet configure failed"
+}
+run_test 6 "socklnd conns_per_peer is range checked"
+
 cleanup_netns
 cleanup_lnet
 exit_status
@@ -8618,6 +8618,78 @@ test_101g() {
 }
 run_test 101g "Big bulk(4/16 MiB) readahead"
 
+test_101h() {
+	local file=$DIR/$tfile
+	local cmd="o"
+	local streams
+	local hits
+	local miss
+	local i
+
+	[ $PARALLEL == "yes" ] && skip "skip parallel run"
+
+	$LFS setstripe -c 1 -i 0 $file || error "setstripe $file failed"
+	dd if=/dev/zero of=$file bs=1M count=64 || error "dd $file failed"
+	cancel_lru_locks $OSC
+	$LCTL set_param -n llite.*.read_ahead_stats 0
+
+	# two sequential readers interleaved through the same file descriptor
+	for ((i = 0; i < 32; i++)); do
+		cmd+="z$((i << 20))r1048576z$(((i + 32) << 20))r1048576"
+	done
+	$MULTIOP $file ${cmd}c || error "interleaved read of $file failed"
+
+	$LCTL get_param llite.*.read_ahead_stats
+	streams=$($LCTL get_param -n llite.*.read_ahead_stats |
+		  get_named_value 'new read-ahead stream' |
+		  cut -d" " -f1 | calc_total)
+	hits=$($LCTL get_param -n llite.*.read_ahead_stats |
+	       get_named_value 'hits' | cut -d" " -f1 | calc_total)
+	miss=$($LCTL get_param -n llite.*.read_ahead_stats |
+	       get_named_value 'misses' | cut -d" " -f1 | calc_total)
+
+	(( streams > 0 )) || error "no new read-ahead stream started"
+	(( hits > miss )) || error "read-ahead hits $hits, misses $miss"
+	rm -f $file
+}
+run_test 101h "read-ahead of interleaved streams through one fd"
+
+test_101i() {
+	local file=$DIR/$tfile
+	local active
+	local async
+
+	[ $PARALLEL == "yes" ] && skip "skip parallel run"
+
+	active=$($LCTL get_param -n llite.*.max_read_ahead_async_active |
+		 head -n 1)
+	stack_trap "$LCTL set_param llite.*.max_read_ahead_async_active=$active"
+	$LCTL set_param llite.*.max_read_ahead_async_active=2 ||
+		error "set max_read_ahead_async_active failed"
+
+	$LFS setstripe -c 1 -i 0 $file || error "setstripe $file failed"
+	dd if=/dev/zero of=$file bs=1M count=64 || error "dd $file failed"
+	cancel_lru_locks $OSC
+	$LCTL set_param -n llite.*.read_ahead_stats 0
+
+	dd if=$file of=/dev/null bs=64k || error "read $file failed"
+	$LCTL get_param llite.*.read_ahead_stats
+	async=$($LCTL get_param -n llite.*.read_ahead_stats |
+		get_named_value 'async readahead' | cut -d" " -f1 | calc_total)
+	(( async > 0 )) || error "no read-ahead issued asynchronously"
+
+	# with async read-ahead disabled everything is read ahead inline
+	$LCTL set_param llite.*.max_read_ahead_async_active=0
+	cancel_lru_locks $OSC
+	$LCTL set_param -n llite.*.read_ahead_stats 0
+	dd if=$file of=/dev/null bs=64k || error "read $file failed"
+	async=$($LCTL get_param -n llite.*.read_ahead_stats |
+		get_named_value 'async readahead' | cut -d" " -f1 | calc_total)
+	(( async == 0 )) || error "$async async read-ahead while disabled"
+	rm -f $file
+}
+run_test 101i "read-ahead hits are issued asynchronously"
+
 setup_test102() {
 	test_mkdir $DIR/$tdir
 	chown $RUNAS_ID $DIR/$tdir
@@ -9480,7 +9552,7 @@ test_115() {
 	[ $PARALLEL == "yes" ] && skip "skip parallel run"
 	remote_ost_nodsh && skip "remote OST with nodsh"
 
-	# Lustre does not stop service threads once they are started.
+	# Service threads only exit after being idle for threads_idle_timeout.
 	# Reset number of running threads to default.
 	stopall
 	setupall
@@ -9580,6 +9652,39 @@ test_115() {
 }
 run_test 115 "verify dynamic thread creation===================="
 
+test_115b() {
+	remote_ost_nodsh && skip "remote OST with nodsh"
+
+	local param="ost.OSS.ost_io"
+	local save_params="$TMP/sanity-$TESTNAME.parameters"
+	local started=$(do_facet ost1 \
+		"$LCTL get_param -n $param.threads_started")
+	local min=$(do_facet ost1 "$LCTL get_param -n $param.threads_min")
+	local retired=$(do_facet ost1 \
+		"$LCTL get_param -n $param.threads_retired" 2>/dev/null)
+
+	[ -n "$retired" ] || skip "no thread retirement support"
+	[ $started -gt $min ] ||
+		skip "no ost_io threads above threads_min ($started/$min)"
+
+	save_lustre_params ost1 "$param.threads_idle_timeout" > $save_params
+	do_facet ost1 "$LCTL set_param $param.threads_idle_timeout=2"
+
+	# idle threads are woken up to wait with the new timeout, allow a
+	# few idle periods for all of them to time out
+	wait_update_facet ost1 "$LCTL get_param -n $param.threads_started" \
+		$min 20
+	local rc=$?
+
+	restore_lustre_params < $save_params
+	rm -f $save_params
+
+	[ $rc -eq 0 ] || error "idle ost_io threads were not retired"
+	[ $(do_facet ost1 "$LCTL get_param -n $param.threads_retired") -gt \
+	  $retired ] || error "threads_retired was not updated"
+}
+run_test 115b "verify idle service threads are retired"
+
 free_min_max () {
 	wait_delete_completed
 	AVAIL=($(lctl get_param -n osc.*[oO][sS][cC]-[^M]*.kbytesavail))
@@ -10190,6 +10295,35 @@ test_118n()
 }
 run_test 118n "statfs() sends OST_STATFS requests in parallel"
 
+test_118o() {
+	local i
+
+	[ $PARALLEL == "yes" ] && skip "skip parallel run"
+
+	test_mkdir $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir ||
+		error "setstripe $DIR/$tdir failed"
+	clear_stats osc.*.osc_stats
+
+	# parallel writers sharing one OST, each dirtying whole extents
+	for i in $(seq 8); do
+		dd if=/dev/zero of=$DIR/$tdir/$tfile.$i bs=1M count=16 \
+			2>/dev/null &
+	done
+	wait
+	sync
+
+	$LCTL get_param osc.*.osc_stats | grep loi_list_lock_contended ||
+		error "no loi_list_lock_contended in osc_stats"
+
+	# unused dirty page reservations must have been returned
+	for i in $($LCTL get_param -n osc.*.cur_dirty_bytes); do
+		(( i == 0 )) || error "cur_dirty_bytes $i after sync"
+	done
+	rm -rf $DIR/$tdir
+}
+run_test 118o "dirty page reservation is released after parallel writes"
+
 test_119a() # bug 11737
 {
         BSIZE=$((512 * 1024))
@@ -10255,6 +10389,61 @@ test_119d() # bug 15950
 }
 run_test 119d "The DIO path should try to send a new rpc once one is completed"
 
+test_119e() {
+	[[ $OSTCOUNT -lt 2 ]] && skip_env "needs >= 2 OSTs"
+
+	local file=$DIR/$tfile
+	local src=$TMP/$tfile.src
+
+	$LFS setstripe -c $OSTCOUNT -S 1M $file || error "setstripe failed"
+	dd if=/dev/urandom of=$src bs=1M count=$((OSTCOUNT * 4)) ||
+		error "cannot create $src"
+
+	# one write covering all stripes several times, issued in parallel
+	dd if=$src of=$file bs=$((OSTCOUNT * 4))M count=1 oflag=direct ||
+		error "direct write failed"
+	cancel_lru_locks osc
+	cmp $src $file || error "$file differs from $src"
+
+	# overwrite part of it to check stripes are not reordered
+	dd if=/dev/zero of=$src bs=1M count=$((OSTCOUNT + 1)) seek=1 \
+		conv=notrunc || error "cannot update $src"
+	dd if=$src of=$file bs=$((OSTCOUNT + 1))M count=1 skip=1 seek=1 \
+		oflag=direct conv=notrunc || error "direct overwrite failed"
+	cancel_lru_locks osc
+	cmp $src $file || error "$file differs from $src after overwrite"
+
+	rm -f $src $file
+}
+run_test 119e "multi-stripe direct write issues stripes in parallel"
+
+test_119f() {
+	local file=$DIR/$tfile
+	local src=$TMP/$tfile.src
+	local pid
+
+	$LFS setstripe -c $OSTCOUNT -S 1M $file || error "setstripe failed"
+	dd if=/dev/zero of=$file bs=1M count=64 || error "cannot create $file"
+	dd if=/dev/urandom of=$src bs=1M count=64 ||
+		error "cannot create $src"
+
+	# buffered reads of the file while a large direct write replaces
+	# its content must not leave the old data in the page cache
+	dd if=$src of=$file bs=64M count=1 oflag=direct conv=notrunc &
+	pid=$!
+	while kill -0 $pid 2> /dev/null; do
+		cat $file > /dev/null
+	done
+	wait $pid || error "direct write failed"
+
+	cmp $src $file || error "stale data read from the page cache"
+	cancel_lru_locks osc
+	cmp $src $file || error "$file differs from $src"
+
+	rm -f $src $file
+}
+run_test 119f "reads during a large direct write don't cache old data"
+
 test_120a() {
 	[ $PARALLEL == "yes" ] && skip "skip parallel run"
 	remote_mds_nodsh && skip "remote MDS with nodsh"
@@ -10651,6 +10840,83 @@ test_123c() {
 }
 run_test 123c "Can not initialize inode warning on DNE statahead"
 
+test_123d() {
+	local stats="llite.*.statahead_stats"
+	local before
+	local after
+	local i
+
+	test_mkdir $DIR/$tdir
+	test_mkdir $DIR/$tdir/a
+	test_mkdir $DIR/$tdir/b
+	createmany -o $DIR/$tdir/a/f 10 || error "createmany failed"
+	for i in $(seq 0 9); do
+		ln $DIR/$tdir/a/f$i $DIR/$tdir/b/f$i || error "ln f$i failed"
+	done
+
+	remount_client $MOUNT
+	# cache the inodes and their locks through the names in a/
+	stat $DIR/$tdir/a/f* > /dev/null || error "stat a/ failed"
+
+	before=$($LCTL get_param -n $stats |
+		 awk '/readdir prefilled:/ { print $3 }')
+	# readdir of b/ instantiates the names of the cached inodes
+	ls $DIR/$tdir/b > /dev/null || error "ls b/ failed"
+	stat $DIR/$tdir/b/f* > /dev/null || error "stat b/ failed"
+	after=$($LCTL get_param -n $stats |
+		awk '/readdir prefilled:/ { print $3 }')
+	$LCTL get_param -n $stats
+
+	(( after > before )) ||
+		error "no dentry prefilled by readdir: $before -> $after"
+	rm -rf $DIR/$tdir
+}
+run_test 123d "readdir instantiates the dentries of cached inodes"
+
+test_123e() {
+	local stats="llite.*.statahead_stats"
+	local before
+	local after
+	local first
+	local i
+
+	test_mkdir $DIR/$tdir
+	test_mkdir $DIR/$tdir/a
+	test_mkdir $DIR/$tdir/b
+	createmany -o $DIR/$tdir/a/f 10 || error "createmany failed"
+	for i in $(seq 0 9); do
+		ln $DIR/$tdir/a/f$i $DIR/$tdir/b/f$i || error "ln f$i failed"
+	done
+
+	remount_client $MOUNT
+	# no inode is cached yet, so this readdir doesn't instantiate the
+	# dentries of b/
+	first=$(ls -U $DIR/$tdir/b | head -n 1)
+	[ -n "$first" ] || error "ls b/ failed"
+	# cache the inodes and their locks through the names in a/
+	stat $DIR/$tdir/a/f* > /dev/null || error "stat a/ failed"
+
+	before=$($LCTL get_param -n $stats |
+		 awk '/statahead cached:/ { print $3 }')
+	# b/ is opened and its entries stat'ed by this shell, starting with
+	# the first one, so that statahead is started and finds the inodes
+	# already cached
+	exec 5<$DIR/$tdir/b
+	[ -e $DIR/$tdir/b/$first ] || error "b/$first missing"
+	for i in $(seq 0 9); do
+		[ -e $DIR/$tdir/b/f$i ] || error "b/f$i missing"
+	done
+	exec 5<&-
+	after=$($LCTL get_param -n $stats |
+		awk '/statahead cached:/ { print $3 }')
+	$LCTL get_param -n $stats
+
+	(( after > before )) ||
+		error "no cached inode used by statahead: $before -> $after"
+	rm -rf $DIR/$tdir
+}
+run_test 123e "statahead uses cached inodes without RPC"
+
 test_124a() {
 	[ $PARALLEL == "yes" ] && skip "skip parallel run"
 	$LCTL get_param -n mdc.*.connect_flags | grep -q lru_resize ||
@@ -18490,6 +18756,46 @@ test_271f() {
 }
 run_test 271f "DoM: read on open (200K file and read tail)"
 
+test_271fa() {
+	[ $MDS1_VERSION -lt $(version_code 2.10.57) ] &&
+		skip "Need MDS version at least 2.10.57"
+	$LCTL list_param mdc.*.mdc_dom_max_repsize ||
+		skip "client cannot size the open reply for whole file"
+
+	local dom=$DIR/$tdir/dom
+	local tmp=$TMP/$tfile
+	local old=$($LCTL get_param -n mdc.*.mdc_dom_max_repsize | head -n1)
+
+	stack_trap "rm -f $tmp" EXIT
+	stack_trap "$LCTL set_param -n mdc.*.mdc_dom_max_repsize=$old" EXIT
+	$LCTL set_param -n mdc.*.mdc_dom_max_repsize=262144
+
+	mkdir -p $DIR/$tdir
+	$LFS setstripe -E 1024K -L mdt $DIR/$tdir
+
+	local mdtidx=$($LFS getstripe --mdt-index $DIR/$tdir)
+
+	dd if=/dev/urandom of=$tmp bs=200000 count=1
+	dd if=$tmp of=$dom bs=200000 count=1
+	cancel_lru_locks mdc
+	# size is known on the client, data is not cached
+	stat $dom > /dev/null
+	lctl set_param -n mdc.*.stats=clear
+
+	echo "Open and read file"
+	cat $dom > /dev/null
+	local num=$(get_mdc_stats $mdtidx ost_read)
+	local ra=$(get_mdc_stats $mdtidx req_active)
+	local rw=$(get_mdc_stats $mdtidx req_waittime)
+
+	[ -z $num ] || error "$num READ RPC occured"
+	[ $ra == $rw ] || error "$((ra - rw)) resend occured"
+	echo "... DONE"
+
+	cmp $tmp $dom || error "file miscompare"
+}
+run_test 271fa "DoM: read on open (whole 200K file with known size)"
+
 test_271g() {
 	[[ $($LCTL get_param mdc.*.import) =~ async_discard ]] ||
 		skip "Skipping due to old client or server version"
@@ -21696,6 +22002,241 @@ test_818() {
 }
 run_test 818 "unlink with failed llog"
 
+test_820() {
+	local param="osp.$FSNAME-OST0000-osc-MDT0000.sync_cancelled"
+	local count=500
+	local recs0 batches0 recs1 batches1
+
+	do_facet mds1 $LCTL list_param $param ||
+		skip "MDS does not report sync_cancelled"
+
+	wait_delete_completed
+	read recs0 batches0 <<< $(do_facet mds1 $LCTL get_param -n $param)
+
+	test_mkdir -i 0 -c 1 $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+	createmany -o $DIR/$tdir/f $count || error "createmany failed"
+	unlinkmany $DIR/$tdir/f $count || error "unlinkmany failed"
+	wait_delete_completed
+
+	read recs1 batches1 <<< $(do_facet mds1 $LCTL get_param -n $param)
+	echo "cancelled $((recs1 - recs0)) records" \
+	     "in $((batches1 - batches0)) batches"
+	(( recs1 - recs0 >= count )) ||
+		error "only $((recs1 - recs0)) of $count records cancelled"
+	(( batches1 - batches0 < recs1 - recs0 )) ||
+		error "records were not cancelled in batches"
+	do_facet mds1 $LCTL get_param \
+		osp.$FSNAME-OST0000-osc-MDT0000.sync_drain_rate
+}
+run_test 820 "osp cancels committed unlink llog records in batches"
+
+test_821() {
+	local osp="osp.$FSNAME-OST0000-osc-MDT0000"
+	local param="$osp.precreate_stats"
+	local count=2000
+	local before after
+	local window stalls
+
+	do_facet mds1 $LCTL list_param $param ||
+		skip "MDS does not report precreate_stats"
+
+	test_mkdir -i 0 -c 1 $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+
+	# start the burst from the smallest window
+	do_facet mds1 $LCTL set_param $osp.create_count=32
+	do_facet mds1 $LCTL set_param $param=clear
+	before=$(do_facet mds1 $LCTL get_param -n $param |
+		 awk '/objects_consumed/ { print $2 }')
+
+	# delay the next precreate RPC once so that creates run out of
+	# precreated objects and wait
+	#define OBD_FAIL_OSP_PRECREATE_DELAY	0x2107
+	do_facet mds1 $LCTL set_param fail_val=2 fail_loc=0x80002107
+	createmany -o $DIR/$tdir/f $count || error "createmany failed"
+	do_facet mds1 $LCTL set_param fail_val=0 fail_loc=0
+
+	do_facet mds1 $LCTL get_param $param
+	after=$(do_facet mds1 $LCTL get_param -n $param |
+		awk '/objects_consumed/ { print $2 }')
+	(( after - before >= count )) ||
+		error "only $((after - before)) of $count objects accounted"
+
+	window=$(do_facet mds1 $LCTL get_param -n $param |
+		 awk '/^create_count:/ { print $2 }')
+	(( window > 32 )) || error "precreate window did not grow: $window"
+
+	stalls=$(do_facet mds1 $LCTL get_param -n $param |
+		 awk '/create_stalls:/ { print $2 }')
+	(( stalls > 0 )) || error "no create stall in the histogram"
+
+	unlinkmany $DIR/$tdir/f $count || error "unlinkmany failed"
+}
+run_test 821 "precreate_stats accounts consumed objects"
+
+test_822() {
+	local param="mdt.$FSNAME-MDT0000.reply_slot_stats"
+	local count=1000
+	local allocs cached
+
+	do_facet mds1 $LCTL list_param $param ||
+		skip "MDS does not report reply_slot_stats"
+
+	test_mkdir -i 0 -c 1 $DIR/$tdir
+	createmany -m $DIR/$tdir/f $count || error "createmany failed"
+	unlinkmany $DIR/$tdir/f $count || error "unlinkmany failed"
+
+	do_facet mds1 $LCTL get_param $param
+	allocs=$(do_facet mds1 $LCTL get_param -n $param |
+		 awk '/allocs:/ { print $2 }')
+	cached=$(do_facet mds1 $LCTL get_param -n $param |
+		 awk '/cached:/ { print $2 }')
+	(( allocs >= 2 * count )) ||
+		error "only $allocs reply slots allocated"
+	(( cached > 0 )) || error "no reply slot reused from the cache"
+}
+run_test 822 "reply data slots are reused from the per-CPT cache"
+
+short_io_rpcs() {
+	local stats=$1
+	local op=$2
+
+	$LCTL get_param -n $stats |
+		awk '/short_io_'$op'_rpcs/ { sum += $2 } END { print sum + 0 }'
+}
+
+test_823() {
+	local src=$TMP/$tfile.src
+	local osc_stats="osc.$FSNAME-OST0000-osc-[^mM]*.osc_stats"
+	local mdc_stats="mdc.$FSNAME-MDT0000-mdc-*.mdc_stats"
+	local old_osc
+	local old_mdc
+	local rpcs
+
+	old_osc=$($LCTL get_param -n osc.*.short_io_bytes | head -n1)
+	old_mdc=$($LCTL get_param -n mdc.*.short_io_bytes | head -n1)
+	[ -n "$old_osc" ] || skip "no short io support"
+	stack_trap "$LCTL set_param -n osc.*.short_io_bytes=$old_osc \
+		    mdc.*.short_io_bytes=$old_mdc" EXIT
+	$LCTL set_param -n osc.*.short_io_bytes=65536 2>/dev/null ||
+		skip "short_io_bytes cannot be set to 64KiB"
+	$LCTL set_param -n mdc.*.short_io_bytes=65536
+
+	dd if=/dev/urandom of=$src bs=32k count=1 || error "cannot create $src"
+	stack_trap "rm -f $src" EXIT
+
+	$LFS setstripe -c 1 -i 0 $DIR/$tfile || error "setstripe failed"
+	$LCTL set_param -n $osc_stats=0
+	dd if=$src of=$DIR/$tfile bs=32k count=1 conv=fsync ||
+		error "short write failed"
+	cancel_lru_locks osc
+	cmp $src $DIR/$tfile || error "short read returned wrong data"
+	$LCTL get_param $osc_stats
+	rpcs=$(short_io_rpcs $osc_stats read)
+	(( rpcs > 0 )) || error "32KiB read didn't use short io"
+
+	if (( $MDS1_VERSION >= $(version_code 2.11.50) )); then
+		local read_open=$(do_facet mds1 $LCTL get_param -n \
+				  mdt.$FSNAME-MDT0000.dom_read_open)
+
+		# read the DoM data with a BRW, not in the open reply
+		if [ -n "$read_open" ]; then
+			do_facet mds1 $LCTL set_param -n \
+				mdt.$FSNAME-MDT0000.dom_read_open=0
+			stack_trap "do_facet mds1 $LCTL set_param -n \
+				mdt.$FSNAME-MDT0000.dom_read_open=$read_open" EXIT
+		fi
+		$LFS setstripe -E 1M -L mdt $DIR/$tfile.dom ||
+			error "cannot create DoM file"
+		$LCTL set_param -n $mdc_stats=0
+		dd if=$src of=$DIR/$tfile.dom bs=32k count=1 conv=fsync ||
+			error "DoM write failed"
+		cancel_lru_locks mdc
+		cmp $src $DIR/$tfile.dom ||
+			error "DoM short read returned wrong data"
+		$LCTL get_param $mdc_stats
+		rpcs=$(short_io_rpcs $mdc_stats read)
+		(( rpcs > 0 )) || error "32KiB DoM read didn't use short io"
+	fi
+}
+run_test 823 "short io reads up to 64KiB"
+
+test_824() {
+	local param=/sys/module/osc/parameters/osc_writeback_spread
+	local src=$TMP/$tfile.src
+	local size=$((OSTCOUNT * 4))
+	local writes
+	local osc
+
+	[ -f $param ] || skip "osc writeback work is not spread over CPTs"
+	echo "osc_writeback_spread=$(cat $param)," \
+	     "$(check_cpt_number client) CPTs"
+
+	dd if=/dev/urandom of=$src bs=1M count=$size ||
+		error "cannot create $src"
+	stack_trap "rm -f $src" EXIT
+
+	$LFS setstripe -c -1 -S 1M $DIR/$tfile || error "setstripe failed"
+	$LCTL set_param -n osc.*.stats=0
+	# a single buffered write queues the writeback work of every OSC
+	dd if=$src of=$DIR/$tfile bs=${size}M count=1 ||
+		error "striped write failed"
+	cancel_lru_locks osc
+	cmp $src $DIR/$tfile || error "striped write returned wrong data"
+
+	for osc in $($LCTL list_param osc.*-osc-[^mM]* | cut -d. -f2); do
+		writes=$($LCTL get_param -n osc.$osc.stats |
+			 awk '/^ost_write/ { print $2 }')
+		(( ${writes:-0} > 0 )) || error "$osc sent no write RPC"
+	done
+}
+run_test 824 "writeback of a wide striped file uses every OSC"
+
+test_825_slv() {
+	local pool=$1
+
+	# the reply of a glimpse brings the SLV the OST sends this client
+	cancel_lru_locks osc
+	stat $DIR/$tfile > /dev/null || error "stat $tfile failed"
+	sleep 2
+	$LCTL get_param -n $pool.server_lock_volume
+}
+
+test_825() {
+	local name=$($LFS getname $MOUNT | cut -d' ' -f1)
+	local pool="ldlm.namespaces.$FSNAME-OST0000-osc-${name##*-}.pool"
+	local old
+	local period
+	local slv_off
+	local slv_on
+
+	old=$(do_facet ost1 $LCTL get_param -n ldlm.lock_fair_share) ||
+		skip "server does not share the lock pool between clients"
+	$LCTL get_param -n osc.$FSNAME-OST0000-osc-${name##*-}.import |
+		grep -q lru_resize || skip "no lru resize support"
+	stack_trap "do_facet ost1 $LCTL set_param ldlm.lock_fair_share=$old" \
+		EXIT
+	period=$($LCTL get_param -n $pool.recalc_period)
+	stack_trap "$LCTL set_param -n $pool.recalc_period=$period" EXIT
+	$LCTL set_param -n $pool.recalc_period=1
+
+	$LFS setstripe -c 1 -i 0 $DIR/$tfile || error "setstripe failed"
+	echo data > $DIR/$tfile || error "write $tfile failed"
+
+	do_facet ost1 $LCTL set_param ldlm.lock_fair_share=0
+	slv_off=$(test_825_slv $pool)
+	do_facet ost1 $LCTL set_param ldlm.lock_fair_share=1
+	slv_on=$(test_825_slv $pool)
+	echo "SLV $slv_off without fair share, $slv_on with it"
+
+	# this client holds far less than its share of the locks of the
+	# pool, so it is sent twice the volume of the pool
+	(( slv_on > slv_off * 3 / 2 )) ||
+		error "SLV $slv_on not raised from $slv_off for a light client"
+}
+run_test 825 "OST sends a higher SLV to a client below its lock share"
+
 #
 # tests that do cleanup/setup should be run at the end
 #
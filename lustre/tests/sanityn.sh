@@ -3912,6 +3912,77 @@ test_77n() { #LU-10802
 }
 run_test 77n "check wildcard support for TBF JobID NRS policy"
 
+test_77o() {
+	local client1=${CLIENT1:-$(hostname)}
+	local dir=$DIR/$tdir
+	local np
+	local start
+	local pid_w
+	local pid_r
+	local time_w
+	local time_r
+	local rate
+
+	do_nodes $(comma_list $(osts_nodes)) \
+		lctl set_param ost.OSS.ost_io.nrs_policies="tbf" \
+			ost.OSS.ost_io.nrs_tbf_rule="start\ ext_u\ uid={500}\ rate=5"
+	trap "cleanup_77k \"ext_uw ext_ur ext_u\" \"fifo\"" EXIT
+
+	# servers which don't know the parent option refuse the rule
+	do_nodes $(comma_list $(osts_nodes)) \
+		lctl set_param ost.OSS.ost_io.nrs_tbf_rule="start\ ext_uw\ uid={500}\&opcode={ost_write}\ rate=20\ parent=ext_u" ||
+		skip "no hierarchical TBF rule support on OSTs"
+	do_nodes $(comma_list $(osts_nodes)) \
+		lctl set_param ost.OSS.ost_io.nrs_tbf_rule="start\ ext_ur\ uid={500}\&opcode={ost_read}\ rate=20\ parent=ext_u" ||
+		error "cannot start child rule ext_ur"
+
+	# a parent rule can't be stopped while it has children
+	do_facet ost1 lctl set_param \
+		ost.OSS.ost_io.nrs_tbf_rule="stop\ ext_u" &&
+		error "parent rule ext_u stopped with children"
+
+	# requests of both children are capped by the parent rate
+	nrs_write_read "runas -u 500"
+	tbf_verify 5 5 "runas -u 500"
+
+	# a writer and a reader running together share the parent rate:
+	# their sum stays under it and neither of them is starved
+	np=$(check_cpt_number ost1)
+	mkdir -p $dir || error "mkdir $dir failed"
+	$LFS setstripe -c 1 -i 0 $dir || error "setstripe to $dir failed"
+	chmod 777 $dir
+	do_node $client1 dd if=/dev/zero of=$dir/tbf_r bs=1M count=50 ||
+		error "cannot create $dir/tbf_r"
+	cancel_lru_locks osc
+
+	start=$SECONDS
+	(do_node $client1 runas -u 500 dd if=/dev/zero of=$dir/tbf_w \
+		bs=1M count=50 oflag=direct &&
+		echo $((SECONDS - start + 1)) > $TMP/$tfile.w) &
+	pid_w=$!
+	(do_node $client1 runas -u 500 dd if=$dir/tbf_r of=/dev/null \
+		bs=1M count=50 iflag=direct &&
+		echo $((SECONDS - start + 1)) > $TMP/$tfile.r) &
+	pid_r=$!
+	wait $pid_w || error "concurrent write failed"
+	wait $pid_r || error "concurrent read failed"
+	time_w=$(cat $TMP/$tfile.w)
+	time_r=$(cat $TMP/$tfile.r)
+	rm -f $TMP/$tfile.w $TMP/$tfile.r
+	echo "write took $time_w s, read took $time_r s"
+
+	rate=$(bc <<< "scale=6; 100 / $((time_w > time_r ? time_w : time_r))")
+	[ $(bc <<< "$rate < 1.1 * $np * 5") -eq 1 ] ||
+		error "shared rate $rate exceeds 110% of parent rate (5 * $np)"
+	# whichever finished first, the other one progressed meanwhile
+	(( time_w * 2 >= time_r && time_r * 2 >= time_w )) ||
+		error "not shared: write took $time_w s, read $time_r s"
+	rm -rf $dir
+
+	cleanup_77k "ext_uw ext_ur ext_u" "fifo"
+}
+run_test 77o "check hierarchical TBF rules with parent rate"
+
 test_78() { #LU-6673
 	local rc
 
@@ -4808,6 +4879,167 @@ test_104() {
 }
 run_test 104 "Verify that MDS stores atime/mtime/ctime during close"
 
+# sets test_105_asts to the blocking ASTs sent during the writes, it is not
+# run in a subshell so that error() aborts the test
+test_105_write() {
+	local param="ldlm.namespaces.filter-*OST0000*.lock_bl_ast_count"
+	local before
+	local after
+	local i
+
+	rm -f $DIR/$tfile
+	$LFS setstripe -c 1 -i 0 $DIR/$tfile || error "setstripe failed"
+	before=$(do_facet ost1 $LCTL get_param -n $param)
+	# two clients each writing their own half of the file in turn
+	for i in $(seq 0 15); do
+		dd if=/dev/zero of=$DIR/$tfile bs=1M count=1 seek=$i \
+			conv=notrunc 2>/dev/null || error "write $i failed"
+		dd if=/dev/zero of=$DIR2/$tfile bs=1M count=1 \
+			seek=$((i + 16)) conv=notrunc 2>/dev/null ||
+			error "write $((i + 16)) failed"
+	done
+	after=$(do_facet ost1 $LCTL get_param -n $param)
+	test_105_asts=$((after - before))
+}
+
+test_105() {
+	local param="ldlm.namespaces.filter-*OST0000*.lock_expand_pattern"
+	local old
+	local off
+	local on
+
+	old=$(do_facet ost1 $LCTL get_param -n $param 2>/dev/null)
+	[ -n "$old" ] || skip "OST does not track writer access patterns"
+	stack_trap "do_facet ost1 $LCTL set_param -n $param=$old" EXIT
+
+	do_facet ost1 $LCTL set_param -n $param=0
+	test_105_write
+	off=$test_105_asts
+	do_facet ost1 $LCTL set_param -n $param=1
+	test_105_write
+	on=$test_105_asts
+	echo "blocking ASTs: $off without patterns, $on with patterns"
+
+	(( on < off )) || error "blocking ASTs not reduced: $on >= $off"
+	do_facet ost1 $LCTL get_param \
+		ldlm.namespaces.filter-*OST0000*.lock_expand_limited_count
+	rm -f $DIR/$tfile
+}
+run_test 105 "write lock expansion follows the pattern of each writer"
+
+test_106() {
+	local name=$($LFS getname $MOUNT | cut -d' ' -f1)
+	local osc="$FSNAME-OST0000-osc-${name##*-}"
+	local ns="ldlm.namespaces.$osc"
+	local old
+	local count
+	local enq
+
+	mkdir -p $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+	old=$($LCTL get_param -n $ns.lru_size)
+	stack_trap "$LCTL set_param -n $ns.lru_size=$old" EXIT
+
+	cancel_lru_locks osc
+	# the lock of f1 is put in the LRU before the lock of f2, and f1
+	# keeps dirty pages under it
+	dd if=/dev/zero of=$DIR/$tdir/f1 bs=4k count=1 ||
+		error "write f1 failed"
+	dd if=/dev/zero of=$DIR/$tdir/f2 bs=4k count=1 oflag=sync ||
+		error "write f2 failed"
+	count=$($LCTL get_param -n $ns.lock_unused_count)
+	(( count == 2 )) || error "$count unused locks, expected 2"
+
+	# writeback of f1 looks its lock up with LDLM_FL_TEST_LOCK, without
+	# taking a reference, so the lock is only marked as touched in the LRU
+	sync
+
+	# cancel the least recently used lock, which is now the one of f2,
+	# and wait for the asynchronous cancel to finish
+	$LCTL set_param -n $ns.lru_size=1
+	wait_update $HOSTNAME "$LCTL get_param -n $ns.lock_count" 1 ||
+		error "locks not shrunk to 1"
+
+	# reading f1 again must not need a new lock
+	enq=$($LCTL get_param -n osc.$osc.stats |
+	      awk '/^ldlm_enqueue/ { print $2 }')
+	cat $DIR/$tdir/f1 > /dev/null || error "read f1 failed"
+	count=$($LCTL get_param -n osc.$osc.stats |
+		awk '/^ldlm_enqueue/ { print $2 }')
+	(( ${count:-0} == ${enq:-0} )) ||
+		error "lock of f1 was cancelled, $enq -> $count enqueues"
+	rm -rf $DIR/$tdir
+}
+run_test 106 "matched locks are moved to the LRU tail"
+
+test_107() {
+	local cnt
+
+	$LFS setstripe -c 1 -i 0 $DIR1/$tfile || error "setstripe failed"
+	# mount1 gets a PW lock expanded over the whole object
+	dd if=/dev/zero of=$DIR1/$tfile bs=4k count=1 conv=notrunc ||
+		error "write from mount1 failed"
+
+	if ! do_facet ost1 $LCTL get_param debug | grep -q dlmtrace; then
+		do_facet ost1 $LCTL set_param debug=+dlmtrace
+		stack_trap "do_facet ost1 $LCTL set_param debug=-dlmtrace" EXIT
+	fi
+	do_facet ost1 $LCTL clear
+
+	# the write from mount2 waits for the lock of mount1, whose cancel
+	# must only reprocess the waiting locks overlapping it
+	dd if=/dev/zero of=$DIR2/$tfile bs=4k count=1 seek=1 conv=notrunc ||
+		error "write from mount2 failed"
+
+	cnt=$(do_facet ost1 $LCTL dk |
+	      grep -c "overlapping the released lock")
+	(( cnt > 0 )) || error "waiting locks were not reprocessed by extent"
+	rm -f $DIR1/$tfile
+}
+run_test 107 "cancel reprocesses waiting extent locks incrementally"
+
+test_108() {
+	local name=$($LFS getname $MOUNT | cut -d' ' -f1)
+	local osc="$FSNAME-OST0000-osc-${name##*-}"
+	local nfiles=64
+	local before
+	local after
+	local size
+	local i
+
+	mkdir -p $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+	for ((i = 0; i < nfiles; i++)); do
+		dd if=/dev/zero of=$DIR/$tdir/f$i bs=4k count=1 \
+			oflag=sync 2>/dev/null || error "write f$i failed"
+	done
+	$LCTL set_param debug=+dlmtrace
+	stack_trap "$LCTL set_param debug=-dlmtrace" EXIT
+	$LCTL clear
+
+	before=$($LCTL get_param -n osc.$osc.stats |
+		 awk '/^ldlm_cancel/ { print $2 }')
+	# truncating all the files at once from the second mount sends the
+	# first mount a burst of blocking ASTs on the same export
+	for ((i = 0; i < nfiles; i++)); do
+		$TRUNCATE $DIR2/$tdir/f$i 0 &
+	done
+	wait
+	after=$($LCTL get_param -n osc.$osc.stats |
+		awk '/^ldlm_cancel/ { print $2 }')
+	echo "$((${after:-0} - ${before:-0})) cancel RPCs for $nfiles locks," \
+	     "$($LCTL dk | grep -c "batched with a pending cancel") batched"
+	(( ${after:-0} - ${before:-0} <= nfiles )) ||
+		error "$before -> $after cancel RPCs for $nfiles locks"
+
+	for ((i = 0; i < nfiles; i++)); do
+		size=$(stat -c %s $DIR/$tdir/f$i)
+		(( size == 0 )) || error "f$i has size $size after truncate"
+	done
+	rm -rf $DIR/$tdir
+}
+run_test 108 "blocking ASTs queued for one export are cancelled together"
+
 log "cleanup: ======================================================"
 
 # kill and wait in each test only guarentee script finish, but command in script